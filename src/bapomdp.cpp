@@ -35,10 +35,20 @@ int main(int argc, char* argv[])
     /***** run program *****/
     try
     {
+        auto const bapomdp = factory::makeTBAPOMDP(conf);
+
+        if (!conf.service.empty())
+        {
+            LOG(INFO) << "(" << conf.id << "): Starting BAPOMDP service";
+            experiment::bapomdp::serve(bapomdp.get(), conf);
+            LOG(INFO) << "(" << conf.id << "): Stopped BAPOMDP service";
+
+            return 0;
+        }
+
         LOG(INFO) << "(" << conf.id << "): Starting BAPOMDP experiment";
 
-        auto const bapomdp = factory::makeTBAPOMDP(conf);
-        auto const res     = experiment::bapomdp::run(bapomdp.get(), conf);
+        auto const res = experiment::bapomdp::run(bapomdp.get(), conf);
 
         std::ofstream f(conf.output_file);
         f << res << std::endl;
@@ -18,13 +18,13 @@ FBAPOMDP::FBAPOMDP(
     std::unique_ptr<FBADomainExtension> fba_domain_ext,
     std::unique_ptr<FBAPOMDPPrior> prior,
     rnd::sample::Dir::sampleMethod sample_method,
-    rnd::sample::Dir::sampleMultinominal compute_mult_method) :
+    rnd::sample::Dir::categoryProbability compute_prob_method) :
         BAPOMDP(
             std::move(domain),
             std::move(ba_domain_ext),
             std::unique_ptr<BAPrior>(prior.release()),
             sample_method,
-            compute_mult_method),
+            compute_prob_method),
         _fba_domain_ext(std::move(fba_domain_ext)),
         _domain_feature_size(_fba_domain_ext->domainFeatureSize()),
         _step_sizes(
@@ -88,8 +88,9 @@ std::unique_ptr<BAPOMDP> makeFBAPOMDP(configurations::FBAConf const& c)
     auto sample_method = (c.bayes_sample_method == 0) ? rnd::sample::Dir::sampleFromSampledMult
                                                       : rnd::sample::Dir::sampleFromExpectedMult;
 
-    auto compute_mult_method = (c.bayes_sample_method == 0) ? rnd::sample::Dir::sampleMult
-                                                            : rnd::sample::Dir::expectedMult;
+    auto compute_prob_method = (c.bayes_sample_method == 0)
+                                   ? rnd::sample::Dir::sampledProbability
+                                   : rnd::sample::Dir::expectedProbability;
 
     return std::unique_ptr<BAPOMDP>(new bayes_adaptive::factored::FBAPOMDP(
         std::unique_ptr<POMDP>(domain),
@@ -97,7 +98,7 @@ std::unique_ptr<BAPOMDP> makeFBAPOMDP(configurations::FBAConf const& c)
         std::move(fba_domain_ext),
         std::move(prior),
         sample_method,
-        compute_mult_method));
+        compute_prob_method));
 }
 
 } // namespace factory
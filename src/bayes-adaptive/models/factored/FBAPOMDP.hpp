@@ -31,7 +31,7 @@ public:
         std::unique_ptr<FBADomainExtension> fba_domain_ext,
         std::unique_ptr<FBAPOMDPPrior> prior,
         rnd::sample::Dir::sampleMethod sample_method,
-        rnd::sample::Dir::sampleMultinominal compute_mult_method);
+        rnd::sample::Dir::categoryProbability compute_prob_method);
 
     Domain_Feature_Size const* domainFeatureSize() const;
 
@@ -15,14 +15,14 @@ BAPOMDP::BAPOMDP(
     std::unique_ptr<BADomainExtension> ba_domain_ext,
     std::unique_ptr<BAPrior> prior,
     rnd::sample::Dir::sampleMethod sample_method,
-    rnd::sample::Dir::sampleMultinominal compute_mult_method) :
+    rnd::sample::Dir::categoryProbability compute_prob_method) :
         _domain(std::move(domain)),
         _ba_domain_ext(std::move(ba_domain_ext)),
         _ba_prior(std::move(prior)),
         _observations(_ba_domain_ext->domainSize()._O),
         _domain_size(_ba_domain_ext->domainSize()),
         _sample_method(sample_method),
-        _compute_mult_method(compute_mult_method)
+        _compute_prob_method(compute_prob_method)
 {
     assert(_domain != nullptr);
     assert(_domain_size._A > 0 && _domain_size._O > 0 && _domain_size._S > 0);
@@ -90,12 +90,26 @@ void BAPOMDP::addLegalActions(State const* s, std::vector<Action const*>* action
     _domain->addLegalActions(static_cast<BAState const*>(s)->_domain_state, actions);
 }
 
+Action const* BAPOMDP::generateHeuristicAction(State const* s) const
+{
+    assert(s != nullptr);
+
+    return _domain->generateHeuristicAction(static_cast<BAState const*>(s)->_domain_state);
+}
+
+double BAPOMDP::heuristicValue(State const* s, int steps_to_go) const
+{
+    assert(s != nullptr);
+
+    return _domain->heuristicValue(static_cast<BAState const*>(s)->_domain_state, steps_to_go);
+}
+
 double BAPOMDP::computeObservationProbability(Observation const* o, Action const* a, State const* s)
     const
 {
 
     return static_cast<BAState const*>(s)->computeObservationProbability(
-        o, a, s, _compute_mult_method);
+        o, a, s, _compute_prob_method);
 }
 
 State const* BAPOMDP::sampleStartState() const
@@ -197,15 +211,16 @@ std::unique_ptr<BAPOMDP> makeTBAPOMDP(configurations::BAConf const& c)
     auto const sample_method       = (c.bayes_sample_method == 0)
                                          ? rnd::sample::Dir::sampleFromSampledMult
                                          : rnd::sample::Dir::sampleFromExpectedMult;
-    auto const compute_mult_method = (c.bayes_sample_method == 0) ? rnd::sample::Dir::sampleMult
-                                                                  : rnd::sample::Dir::expectedMult;
+    auto const compute_prob_method = (c.bayes_sample_method == 0)
+                                         ? rnd::sample::Dir::sampledProbability
+                                         : rnd::sample::Dir::expectedProbability;
 
     return std::unique_ptr<BAPOMDP>(new BAPOMDP(
         std::unique_ptr<POMDP>(domain),
         std::move(ba_domain_ext),
         std::move(prior),
         sample_method,
-        compute_mult_method));
+        compute_prob_method));
 }
 
 } // namespace factory
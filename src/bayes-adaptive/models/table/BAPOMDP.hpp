@@ -51,7 +51,7 @@ public:
         std::unique_ptr<BADomainExtension> ba_domain_ext,
         std::unique_ptr<BAPrior> prior,
         rnd::sample::Dir::sampleMethod sample_method,
-        rnd::sample::Dir::sampleMultinominal compute_mult_method);
+        rnd::sample::Dir::categoryProbability compute_prob_method);
 
     StepType mode() const;
     void mode(StepType new_mode) const;
@@ -102,6 +102,8 @@ public:
     /**** POMDP interface *****/
     Action const* generateRandomAction(State const* s) const final;
     void addLegalActions(State const* s, std::vector<Action const*>* actions) const final;
+    Action const* generateHeuristicAction(State const* s) const final;
+    double heuristicValue(State const* s, int steps_to_go) const final;
 
     double computeObservationProbability(Observation const* o, Action const* a, State const* s)
         const final;
@@ -145,7 +147,7 @@ private:
     rnd::sample::Dir::sampleMethod* _sample_method;
 
     // whether to use sampled or expected mult models when computing observation
-    rnd::sample::Dir::sampleMultinominal* _compute_mult_method;
+    rnd::sample::Dir::categoryProbability* _compute_prob_method;
 };
 
 namespace factory {
@@ -0,0 +1,61 @@
+#include "BASimulationState.hpp"
+
+#include <cassert>
+
+BASimulationState::BASimulationState(BAState const* particle, State const* domain_state) :
+        BAState(domain_state), _particle(particle)
+{
+    assert(_particle != nullptr);
+}
+
+BAState* BASimulationState::copy(State const* domain_state) const
+{
+    return new BASimulationState(_particle, domain_state);
+}
+
+void BASimulationState::logCounts() const
+{
+    _particle->logCounts();
+}
+
+int BASimulationState::sampleStateIndex(
+    State const* s,
+    Action const* a,
+    rnd::sample::Dir::sampleMethod m) const
+{
+    return _particle->sampleStateIndex(s, a, m);
+}
+
+int BASimulationState::sampleObservationIndex(
+    Action const* a,
+    State const* new_s,
+    rnd::sample::Dir::sampleMethod m) const
+{
+    return _particle->sampleObservationIndex(a, new_s, m);
+}
+
+double BASimulationState::computeObservationProbability(
+    Observation const* o,
+    Action const* a,
+    State const* new_s,
+    rnd::sample::Dir::categoryProbability m) const
+{
+    return _particle->computeObservationProbability(o, a, new_s, m);
+}
+
+void BASimulationState::incrementCountsOf(
+    State const* /*s*/,
+    Action const* /*a*/,
+    Observation const* /*o*/,
+    State const* /*new_s*/,
+    float /*amount*/)
+{
+    throw "BASimulationState::incrementCountsOf: cannot update the (read-only) counts of a "
+          "particle";
+}
+
+std::string BASimulationState::toString() const
+{
+    // the counts are not part of the description, they would be the particle's
+    return "BASimulationState(" + _domain_state->toString() + ")";
+}
@@ -0,0 +1,71 @@
+#ifndef BASIMULATIONSTATE_HPP
+#define BASIMULATIONSTATE_HPP
+
+#include "bayes-adaptive/states/BAState.hpp"
+
+#include <string>
+
+#include "utils/random.hpp"
+
+class Action;
+class State;
+class Observation;
+
+/**
+ * @brief A lightweight state to simulate with the model of a particle
+ *
+ * Consists of a read-only view of the counts of a `BAState` (the particle)
+ * and its own domain state. Planners can simulate (steps that keep the
+ * counts) with this instead of copying the particle, or modifying it in
+ * place, so that multiple simulations can share the same particle.
+ *
+ * The particle must outlive the state, and its counts can not be updated
+ * through it.
+ **/
+class BASimulationState : public BAState
+{
+public:
+    /**
+     * @brief creates a state with the counts of `particle` and domain state `domain_state`
+     **/
+    BASimulationState(BAState const* particle, State const* domain_state);
+
+    BASimulationState(BASimulationState const&) = delete;
+    BASimulationState& operator=(BASimulationState const&) = delete;
+
+    /*** BAState interface ***/
+    BAState* copy(State const* domain_state) const final;
+    void logCounts() const final;
+
+    int sampleStateIndex(State const* s, Action const* a, rnd::sample::Dir::sampleMethod m)
+        const final;
+
+    int sampleObservationIndex(
+        Action const* a,
+        State const* new_s,
+        rnd::sample::Dir::sampleMethod m) const final;
+
+    double computeObservationProbability(
+        Observation const* o,
+        Action const* a,
+        State const* new_s,
+        rnd::sample::Dir::categoryProbability m) const final;
+
+    /**
+     * @brief throws: the counts of the particle are read-only
+     **/
+    void incrementCountsOf(
+        State const* s,
+        Action const* a,
+        Observation const* o,
+        State const* new_s,
+        float amount = 1) final;
+
+    /*** State interface ***/
+    std::string toString() const final;
+
+private:
+    BAState const* const _particle;
+};
+
+#endif // BASIMULATIONSTATE_HPP
@@ -37,7 +37,7 @@ public:
         Observation const* o,
         Action const* a,
         State const* new_s,
-        rnd::sample::Dir::sampleMultinominal m) const = 0;
+        rnd::sample::Dir::categoryProbability m) const = 0;
 
     /**
      * @brief samples a state index for <s,a>
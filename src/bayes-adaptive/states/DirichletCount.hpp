@@ -0,0 +1,49 @@
+#ifndef DIRICHLETCOUNT_HPP
+#define DIRICHLETCOUNT_HPP
+
+namespace bayes_adaptive {
+
+/**
+ * @brief A writable reference to a count of a dirichlet that keeps the total of the dirichlet
+ *
+ * Models store the total of each of their dirichlets next to the counts, such
+ * that expected probabilities are a single division. Writes through this
+ * reference (`=` and `+=`) update the count and its total alike.
+ **/
+class DirichletCount
+{
+public:
+    DirichletCount(float& count, double& total) : _count(count), _total(total) {}
+
+    operator float() const { return _count; }
+
+    DirichletCount& operator=(float value)
+    {
+        _total += static_cast<double>(value) - _count;
+        _count = value;
+
+        return *this;
+    }
+
+    DirichletCount& operator+=(float amount)
+    {
+        // add what the count actually changed by, which may be rounded
+        auto const old_count = _count;
+        _count += amount;
+        _total += static_cast<double>(_count) - old_count;
+
+        return *this;
+    }
+
+    // a reference can not be reseated: assigning copies the value
+    DirichletCount(DirichletCount const&) = default;
+    DirichletCount& operator=(DirichletCount const& other) { return *this = float(other); }
+
+private:
+    float& _count;
+    double& _total;
+};
+
+} // namespace bayes_adaptive
+
+#endif // DIRICHLETCOUNT_HPP
@@ -329,7 +329,7 @@ double BABNModel::computeObservationProbability(
     Observation const* o,
     Action const* a,
     State const* s,
-    rnd::sample::Dir::sampleMultinominal sampleMultinominal) const
+    rnd::sample::Dir::categoryProbability m) const
 {
     assertLegal(a);
     assertLegal(o);
@@ -344,8 +344,7 @@ double BABNModel::computeObservationProbability(
     // the probbility of each feature
     for (auto n = 0; n < static_cast<int>(_domain_feature_size->_O.size()); ++n)
     {
-        prob *= observationNode(a, n).sampleMultinominal(
-            nodes_input, sampleMultinominal)[feature_values[n]];
+        prob *= observationNode(a, n).probability(nodes_input, feature_values[n], m);
     }
 
     return prob;
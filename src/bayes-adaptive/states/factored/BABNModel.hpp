@@ -99,7 +99,7 @@ public:
         Observation const* o,
         Action const* a,
         State const* s,
-        rnd::sample::Dir::sampleMultinominal sampleMultinominal) const;
+        rnd::sample::Dir::categoryProbability m) const;
 
     /**
      * @brief calculates the BD score of a graph given its prior and posterior
@@ -11,7 +11,7 @@
 #include "utils/index.hpp"
 #include "utils/random.hpp"
 
-std::vector<int> DBNNode::_parent_value_holder;
+thread_local std::vector<int> DBNNode::_parent_value_holder;
 
 DBNNode::DBNNode(
     std::vector<int> const* graph_input_size,
@@ -34,7 +34,8 @@ DBNNode::DBNNode(
         max_parent_values *= _parent_sizes[i];
     }
 
-    _cpts = std::vector<float>(max_parent_values * _output_size);
+    _cpts   = std::vector<float>(max_parent_values * _output_size);
+    _totals = std::vector<double>(max_parent_values);
 }
 
 DBNNode DBNNode::marginalizeOut(std::vector<int> new_parents) const
@@ -76,6 +77,13 @@ DBNNode DBNNode::marginalizeOut(std::vector<int> new_parents) const
 
     assert(cpt_start == _cpts.size());
 
+    // totals follow the (float) summed counts, not the sum of our (exact) totals
+    for (size_t distr = 0; distr < new_node._totals.size(); ++distr)
+    {
+        new_node._totals[distr] =
+            rnd::sample::Dir::dirichletTotal(&new_node._cpts[distr * _output_size], _output_size);
+    }
+
     return new_node;
 }
 
@@ -118,12 +126,18 @@ double DBNNode::LogBDScore(DBNNode const& prior) const
 
 std::vector<float> DBNNode::expectation(std::vector<int> const& node_input) const
 {
-    return rnd::sample::Dir::expectedMult(&_cpts[cptIndex(node_input, 0)], _output_size);
+    auto const distr_start = cptIndex(node_input, 0);
+
+    auto res = std::vector<float>(_output_size);
+    rnd::sample::Dir::expectedMult(
+        &_cpts[distr_start], _output_size, _totals[distr_start / _output_size], res.data());
+
+    return res;
 }
 
 void DBNNode::increment(std::vector<int> const& node_input, int node_output, float amount)
 {
-    _cpts[cptIndex(node_input, node_output)] += amount;
+    count(node_input, node_output) += amount;
 }
 
 void DBNNode::setDirichletDistribution(
@@ -132,12 +146,18 @@ void DBNNode::setDirichletDistribution(
 {
     assert(counts.size() == (size_t)_output_size);
 
-    std::move(counts.begin(), counts.end(), &_cpts[cptIndex(node_input, 0)]);
+    auto const distr_start = cptIndex(node_input, 0);
+
+    _totals[distr_start / _output_size] =
+        rnd::sample::Dir::dirichletTotal(&counts[0], _output_size);
+    std::move(counts.begin(), counts.end(), &_cpts[distr_start]);
 }
 
-float& DBNNode::count(std::vector<int> const& node_input, int node_output)
+bayes_adaptive::DirichletCount
+    DBNNode::count(std::vector<int> const& node_input, int node_output)
 {
-    return _cpts[cptIndex(node_input, node_output)];
+    auto const i = cptIndex(node_input, node_output);
+    return bayes_adaptive::DirichletCount(_cpts[i], _totals[i / _output_size]);
 }
 
 size_t DBNNode::range() const
@@ -158,14 +178,18 @@ std::vector<int> const* DBNNode::parents() const
 int DBNNode::sample(std::vector<int> const& node_input, rnd::sample::Dir::sampleMethod m) const
 {
     // sample from dirichlet starting from joint index for _ouput_size counts
-    return m(&_cpts[cptIndex(node_input, 0)], _output_size);
+    auto const distr_start = cptIndex(node_input, 0);
+    return m(&_cpts[distr_start], _output_size, _totals[distr_start / _output_size]);
 }
 
-std::vector<float> DBNNode::sampleMultinominal(
+double DBNNode::probability(
     std::vector<int> const& node_input,
-    rnd::sample::Dir::sampleMultinominal sampleMethod) const
+    int node_output,
+    rnd::sample::Dir::categoryProbability m) const
 {
-    return sampleMethod(&_cpts[cptIndex(node_input, 0)], _output_size);
+    assert(node_output >= 0 && node_output < _output_size);
+    auto const distr_start = cptIndex(node_input, 0);
+    return m(&_cpts[distr_start], _output_size, _totals[distr_start / _output_size], node_output);
 }
 
 int DBNNode::cptIndex(std::vector<int> const& node_input, int node_output) const
@@ -3,6 +3,7 @@
 
 #include <vector>
 
+#include "bayes-adaptive/states/DirichletCount.hpp"
 #include "utils/random.hpp"
 
 #include <cstddef>
@@ -63,12 +64,12 @@ public:
     int sample(std::vector<int> const& node_input, rnd::sample::Dir::sampleMethod m) const;
 
     /**
-     * @brief returns a multinominal over the output range associated with graph_input according to
-     *sampling method m
+     * @brief returns the probability of node_output given node_input according to method m
      **/
-    std::vector<float> sampleMultinominal(
+    double probability(
         std::vector<int> const& node_input,
-        rnd::sample::Dir::sampleMultinominal sampleMethod) const;
+        int node_output,
+        rnd::sample::Dir::categoryProbability m) const;
 
     /**
      * @brief increments the counts associated with the provided transition <parent_values> to
@@ -78,8 +79,10 @@ public:
 
     /**
      * @brief returns the count of the <X,a,X'> cpt
+     *
+     * Writes through the returned reference keep the total of its dirichlet up to date
      */
-    float& count(std::vector<int> const& node_input, int node_output);
+    bayes_adaptive::DirichletCount count(std::vector<int> const& node_input, int node_output);
 
     /**
      * @brief sets the counts for a particular set of parent values
@@ -117,6 +120,11 @@ private:
      **/
     std::vector<float> _cpts = {};
 
+    /**
+     * @brief the total of the counts of each dirichlet (one per parent values) in _cpts
+     **/
+    std::vector<double> _totals = {};
+
     /**
      * @brief the range of all nodes in the graph (also those not connected to *this*)
      *
@@ -129,9 +137,9 @@ private:
 
     /**
      * @brief many internal functions require to accumulate parent values, this is a memory
-     *efficient way of doing that
+     *efficient way of doing that (one per thread, since planners may sample in parallel)
      **/
-    static std::vector<int> _parent_value_holder;
+    static thread_local std::vector<int> _parent_value_holder;
 
     /**
      * @brief returns the index into the cpt given parent values and desired output
@@ -44,9 +44,9 @@ double FBAPOMDPState::computeObservationProbability(
     Observation const* o,
     Action const* a,
     State const* s,
-    rnd::sample::Dir::sampleMultinominal sampleMultinominal) const
+    rnd::sample::Dir::categoryProbability m) const
 {
-    return _model.computeObservationProbability(o, a, s, sampleMultinominal);
+    return _model.computeObservationProbability(o, a, s, m);
 }
 
 void FBAPOMDPState::incrementCountsOf(
@@ -40,7 +40,7 @@ public:
         Observation const* o,
         Action const* a,
         State const* s,
-        rnd::sample::Dir::sampleMultinominal sampleMultinominal) const final;
+        rnd::sample::Dir::categoryProbability m) const final;
 
     void incrementCountsOf(
         State const* s,
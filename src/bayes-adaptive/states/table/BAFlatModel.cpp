@@ -11,6 +11,25 @@
 
 #include "utils/index.hpp"
 
+namespace {
+
+/**
+ * @brief returns the totals of the dirichlets (of n counts each) that make up counts
+ **/
+std::shared_ptr<std::vector<double> const> dirichletTotals(std::vector<float> const& counts, int n)
+{
+    auto totals = std::vector<double>(counts.size() / n);
+
+    for (size_t i = 0; i < totals.size(); ++i)
+    {
+        totals[i] = rnd::sample::Dir::dirichletTotal(&counts[i * n], n);
+    }
+
+    return std::make_shared<std::vector<double>>(std::move(totals));
+}
+
+} // namespace
+
 namespace bayes_adaptive { namespace table {
 
 BAFlatModel::BAFlatModel() : _domain_size(0) {}
@@ -20,7 +39,9 @@ BAFlatModel::BAFlatModel(Domain_Size const* domain_size) :
         _phi(std::make_shared<std::vector<float>>(
             domain_size->_S * domain_size->_A * domain_size->_S)),
         _psi(std::make_shared<std::vector<float>>(
-            domain_size->_A * domain_size->_S * domain_size->_O))
+            domain_size->_A * domain_size->_S * domain_size->_O)),
+        _phi_totals(std::make_shared<std::vector<double>>(domain_size->_S * domain_size->_A)),
+        _psi_totals(std::make_shared<std::vector<double>>(domain_size->_A * domain_size->_S))
 {
     assert(
         _phi->size()
@@ -34,7 +55,11 @@ BAFlatModel::BAFlatModel(
     std::shared_ptr<std::vector<float> const> phi,
     std::shared_ptr<std::vector<float> const> psi,
     Domain_Size const* domain_size) :
-        _domain_size(domain_size), _phi(std::move(phi)), _psi(std::move(psi))
+        _domain_size(domain_size),
+        _phi(std::move(phi)),
+        _psi(std::move(psi)),
+        _phi_totals(dirichletTotals(*_phi, domain_size->_S)),
+        _psi_totals(dirichletTotals(*_psi, domain_size->_O))
 {
     assert(
         _phi->size()
@@ -44,24 +69,26 @@ BAFlatModel::BAFlatModel(
         == static_cast<size_t>(_domain_size->_A * _domain_size->_S * _domain_size->_O));
 }
 
-float& BAFlatModel::count(State const* s, Action const* a, State const* new_s)
+DirichletCount BAFlatModel::count(State const* s, Action const* a, State const* new_s)
 {
 
     assertLegal(s);
     assertLegal(a);
     assertLegal(new_s);
 
-    return phi(s->index(), a->index(), new_s->index());
+    auto& dir = phi(s->index(), a->index());
+    return DirichletCount(dir.counts[new_s->index()], dir.total);
 }
 
-float& BAFlatModel::count(Action const* a, State const* new_s, Observation const* o)
+DirichletCount BAFlatModel::count(Action const* a, State const* new_s, Observation const* o)
 {
 
     assertLegal(o);
     assertLegal(a);
     assertLegal(new_s);
 
-    return psi(a->index(), new_s->index(), o->index());
+    auto& dir = psi(a->index(), new_s->index());
+    return DirichletCount(dir.counts[o->index()], dir.total);
 }
 
 std::vector<float> BAFlatModel::transitionExpectation(State const* s, Action const* a) const
@@ -69,7 +96,14 @@ std::vector<float> BAFlatModel::transitionExpectation(State const* s, Action con
     assertLegal(s);
     assertLegal(a);
 
-    return rnd::sample::Dir::expectedMult(&phi(s->index(), a->index(), 0), _domain_size->_S);
+    auto res = std::vector<float>(_domain_size->_S);
+    rnd::sample::Dir::expectedMult(
+        &phi(s->index(), a->index(), 0),
+        _domain_size->_S,
+        phi_total(s->index(), a->index()),
+        res.data());
+
+    return res;
 }
 
 std::vector<float> BAFlatModel::observationExpectation(Action const* a, State const* new_s) const
@@ -77,7 +111,14 @@ std::vector<float> BAFlatModel::observationExpectation(Action const* a, State co
     assertLegal(a);
     assertLegal(new_s);
 
-    return rnd::sample::Dir::expectedMult(&psi(a->index(), new_s->index(), 0), _domain_size->_O);
+    auto res = std::vector<float>(_domain_size->_O);
+    rnd::sample::Dir::expectedMult(
+        &psi(a->index(), new_s->index(), 0),
+        _domain_size->_O,
+        psi_total(a->index(), new_s->index()),
+        res.data());
+
+    return res;
 }
 
 int BAFlatModel::sampleStateIndex(State const* s, Action const* a, rnd::sample::Dir::sampleMethod m)
@@ -87,7 +128,8 @@ int BAFlatModel::sampleStateIndex(State const* s, Action const* a, rnd::sample::
     assertLegal(s);
     assertLegal(a);
 
-    return m(&phi(s->index(), a->index(), 0), _domain_size->_S);
+    return m(
+        &phi(s->index(), a->index(), 0), _domain_size->_S, phi_total(s->index(), a->index()));
 }
 
 int BAFlatModel::sampleObservationIndex(
@@ -99,14 +141,17 @@ int BAFlatModel::sampleObservationIndex(
     assertLegal(a);
     assertLegal(new_s);
 
-    return m(&psi(a->index(), new_s->index(), 0), _domain_size->_O);
+    return m(
+        &psi(a->index(), new_s->index(), 0),
+        _domain_size->_O,
+        psi_total(a->index(), new_s->index()));
 }
 
 double BAFlatModel::computeObservationProbability(
     Observation const* o,
     Action const* a,
     State const* new_s,
-    rnd::sample::Dir::sampleMultinominal m) const
+    rnd::sample::Dir::categoryProbability m) const
 {
 
     assertLegal(o);
@@ -119,8 +164,12 @@ double BAFlatModel::computeObservationProbability(
         return 1;
     }
 
-    // samples multinominal & returns the correct index
-    return m(&psi(a->index(), new_s->index(), 0), _domain_size->_O)[o->index()];
+    // (samples multinominal &) returns the probability of the observation
+    return m(
+        &psi(a->index(), new_s->index(), 0),
+        _domain_size->_O,
+        psi_total(a->index(), new_s->index()),
+        o->index());
 }
 
 void BAFlatModel::incrementCountsOf(
@@ -182,7 +231,7 @@ void BAFlatModel::logCounts() const
     }
 }
 
-float& BAFlatModel::phi(int s, int a, int new_s)
+BAFlatModel::Dirichlet& BAFlatModel::phi(int s, int a)
 {
 
     auto const delta_index = phi_cache_index(s, a);
@@ -194,15 +243,17 @@ float& BAFlatModel::phi(int s, int a, int new_s)
 
         auto const phi_index = indexing::threeToOne(s, a, 0, _domain_size->_A, _domain_size->_S);
 
-        cached_phi = _phi_cache
-                         .insert(
-                             {delta_index,
-                              std::vector<float>(
-                                  &_phi->at(phi_index), &_phi->at(phi_index) + _domain_size->_S)})
-                         .first;
+        cached_phi =
+            _phi_cache
+                .insert(
+                    {delta_index,
+                     {std::vector<float>(
+                          &_phi->at(phi_index), &_phi->at(phi_index) + _domain_size->_S),
+                      (*_phi_totals)[delta_index]}})
+                .first;
     }
 
-    return cached_phi->second[new_s];
+    return cached_phi->second;
 }
 
 float const& BAFlatModel::phi(int s, int a, int new_s) const
@@ -212,11 +263,21 @@ float const& BAFlatModel::phi(int s, int a, int new_s) const
     auto const delta_val   = _phi_cache.find(delta_index);
 
     return (delta_val != _phi_cache.end())
-               ? delta_val->second[new_s]
+               ? delta_val->second.counts[new_s]
                : _phi->at(indexing::threeToOne(s, a, new_s, _domain_size->_A, _domain_size->_S));
 }
 
-float& BAFlatModel::psi(int a, int new_s, int o)
+double BAFlatModel::phi_total(int s, int a) const
+{
+
+    auto const delta_index = phi_cache_index(s, a);
+    auto const delta_val   = _phi_cache.find(delta_index);
+
+    return (delta_val != _phi_cache.end()) ? delta_val->second.total
+                                           : (*_phi_totals)[delta_index];
+}
+
+BAFlatModel::Dirichlet& BAFlatModel::psi(int a, int new_s)
 {
 
     auto const delta_index = psi_cache_index(a, new_s);
@@ -229,15 +290,17 @@ float& BAFlatModel::psi(int a, int new_s, int o)
         auto const psi_index =
             indexing::threeToOne(a, new_s, 0, _domain_size->_S, _domain_size->_O);
 
-        cached_psi = _psi_cache
-                         .insert(
-                             {delta_index,
-                              std::vector<float>(
-                                  &_psi->at(psi_index), &_psi->at(psi_index) + _domain_size->_O)})
-                         .first;
+        cached_psi =
+            _psi_cache
+                .insert(
+                    {delta_index,
+                     {std::vector<float>(
+                          &_psi->at(psi_index), &_psi->at(psi_index) + _domain_size->_O),
+                      (*_psi_totals)[delta_index]}})
+                .first;
     }
 
-    return cached_psi->second[o];
+    return cached_psi->second;
 }
 
 float const& BAFlatModel::psi(int a, int new_s, int o) const
@@ -247,10 +310,20 @@ float const& BAFlatModel::psi(int a, int new_s, int o) const
     auto const delta_val   = _psi_cache.find(delta_index);
 
     return (delta_val != _psi_cache.end())
-               ? delta_val->second[o]
+               ? delta_val->second.counts[o]
                : _psi->at(indexing::threeToOne(a, new_s, o, _domain_size->_S, _domain_size->_O));
 }
 
+double BAFlatModel::psi_total(int a, int new_s) const
+{
+
+    auto const delta_index = psi_cache_index(a, new_s);
+    auto const delta_val   = _psi_cache.find(delta_index);
+
+    return (delta_val != _psi_cache.end()) ? delta_val->second.total
+                                           : (*_psi_totals)[delta_index];
+}
+
 unsigned int BAFlatModel::phi_cache_index(int s, int a) const
 {
     return s * _domain_size->_A + a;
@@ -291,8 +364,9 @@ BAFlatModel& BAFlatModel::operator=(BAFlatModel const& other)
     {
 
         // cache still small enough
-        _phi       = other._phi;
-        _phi_cache = other._phi_cache;
+        _phi        = other._phi;
+        _phi_totals = other._phi_totals;
+        _phi_cache  = other._phi_cache;
 
     } else // cache too large
     {
@@ -300,7 +374,8 @@ BAFlatModel& BAFlatModel::operator=(BAFlatModel const& other)
         _phi_cache = {};
 
         // base case is a copy of other phi
-        auto phi = *other._phi;
+        auto phi        = *other._phi;
+        auto phi_totals = *other._phi_totals;
 
         // update all dir in phi_cache
         for (auto const& it : other._phi_cache)
@@ -311,11 +386,13 @@ BAFlatModel& BAFlatModel::operator=(BAFlatModel const& other)
             auto phi_index = indexing::threeToOne(s, a, 0, _domain_size->_A, _domain_size->_S);
 
             // update all entries in dir
-            std::copy(it.second.begin(), it.second.end(), &phi[phi_index]);
+            std::copy(it.second.counts.begin(), it.second.counts.end(), &phi[phi_index]);
+            phi_totals[it.first] = it.second.total;
         }
 
         // store our new phi as shared pointer
-        _phi = std::make_shared<std::vector<float>>(std::move(phi));
+        _phi        = std::make_shared<std::vector<float>>(std::move(phi));
+        _phi_totals = std::make_shared<std::vector<double>>(std::move(phi_totals));
     }
 
     // merge if necessary
@@ -323,8 +400,9 @@ BAFlatModel& BAFlatModel::operator=(BAFlatModel const& other)
     {
 
         // cache still small enough
-        _psi       = other._psi;
-        _psi_cache = other._psi_cache;
+        _psi        = other._psi;
+        _psi_totals = other._psi_totals;
+        _psi_cache  = other._psi_cache;
 
     } else // cache too large
     {
@@ -332,7 +410,8 @@ BAFlatModel& BAFlatModel::operator=(BAFlatModel const& other)
         _psi_cache = {};
 
         // base case is a copy of other psi
-        auto psi = *other._psi;
+        auto psi        = *other._psi;
+        auto psi_totals = *other._psi_totals;
 
         // update all dir in psi_cache
         for (auto const& it : other._psi_cache)
@@ -343,11 +422,13 @@ BAFlatModel& BAFlatModel::operator=(BAFlatModel const& other)
             auto psi_index = indexing::threeToOne(a, new_s, 0, _domain_size->_S, _domain_size->_O);
 
             // update all entries in dir
-            std::copy(it.second.begin(), it.second.end(), &psi[psi_index]);
+            std::copy(it.second.counts.begin(), it.second.counts.end(), &psi[psi_index]);
+            psi_totals[it.first] = it.second.total;
         }
 
         // store our new psi as shared pointer
-        _psi = std::make_shared<std::vector<float>>(std::move(psi));
+        _psi        = std::make_shared<std::vector<float>>(std::move(psi));
+        _psi_totals = std::make_shared<std::vector<double>>(std::move(psi_totals));
     }
 
     return *this;
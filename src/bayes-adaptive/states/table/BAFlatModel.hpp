@@ -6,6 +6,7 @@
 #include <vector>
 
 #include "bayes-adaptive/models/Domain_Size.hpp"
+#include "bayes-adaptive/states/DirichletCount.hpp"
 #include "utils/random.hpp"
 class State;
 class Action;
@@ -43,8 +44,11 @@ public:
     BAFlatModel& operator               =(BAFlatModel const&);
     BAFlatModel& operator=(BAFlatModel&&) = default;
 
-    float& count(State const* s, Action const* a, State const* new_s);
-    float& count(Action const* a, State const* new_s, Observation const* o);
+    /**
+     * @brief returns a reference to a count that keeps the total of its dirichlet up to date
+     **/
+    DirichletCount count(State const* s, Action const* a, State const* new_s);
+    DirichletCount count(Action const* a, State const* new_s, Observation const* o);
 
     /**
      * @brief Returns the expected transition probabilities of state-action s-a
@@ -77,7 +81,7 @@ public:
         Observation const* o,
         Action const* a,
         State const* new_s,
-        rnd::sample::Dir::sampleMultinominal m) const;
+        rnd::sample::Dir::categoryProbability m) const;
 
     void incrementCountsOf(
         State const* s,
@@ -89,14 +93,27 @@ public:
     void logCounts() const;
 
 private:
+    /**
+     * @brief the counts of a dirichlet that has been updated, and their total
+     **/
+    struct Dirichlet
+    {
+        std::vector<float> counts;
+        double total;
+    };
+
     Domain_Size const* _domain_size;
 
     std::shared_ptr<std::vector<float> const> _phi = {}; // base P(T)
     std::shared_ptr<std::vector<float> const> _psi = {}; // base P(O)
 
+    // totals of the dirichlets in the base, indexed like the caches
+    std::shared_ptr<std::vector<double> const> _phi_totals = {};
+    std::shared_ptr<std::vector<double> const> _psi_totals = {};
+
     // updated counts, to be updated over time
-    std::map<unsigned int, std::vector<float>> _phi_cache = {};
-    std::map<unsigned int, std::vector<float>> _psi_cache = {};
+    std::map<unsigned int, Dirichlet> _phi_cache = {};
+    std::map<unsigned int, Dirichlet> _psi_cache = {};
 
     double _cache_ratio_threshold = .1;
 
@@ -104,13 +121,31 @@ private:
      * @brief returns count in phi
      **/
     float const& phi(int s, int a, int new_s) const;
-    float& phi(int s, int a, int new_s);
+
+    /**
+     * @brief returns the (cached, so updatable) dirichlet of s-a in phi
+     **/
+    Dirichlet& phi(int s, int a);
+
+    /**
+     * @brief returns the total of the dirichlet of s-a in phi
+     **/
+    double phi_total(int s, int a) const;
 
     /**
      * @brief returns count in psi
      **/
     float const& psi(int a, int new_s, int o) const;
-    float& psi(int a, int new_s, int o);
+
+    /**
+     * @brief returns the (cached, so updatable) dirichlet of a-new_s in psi
+     **/
+    Dirichlet& psi(int a, int new_s);
+
+    /**
+     * @brief returns the total of the dirichlet of a-new_s in psi
+     **/
+    double psi_total(int a, int new_s) const;
 
     /**
      * @brief returns index into updated storages
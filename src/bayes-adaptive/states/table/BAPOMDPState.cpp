@@ -29,7 +29,7 @@ double BAPOMDPState::computeObservationProbability(
     Observation const* o,
     Action const* a,
     State const* new_s,
-    rnd::sample::Dir::sampleMultinominal m) const
+    rnd::sample::Dir::categoryProbability m) const
 {
     return _model.computeObservationProbability(o, a, new_s, m);
 }
@@ -39,7 +39,7 @@ public:
         Observation const* o,
         Action const* a,
         State const* new_s,
-        rnd::sample::Dir::sampleMultinominal m) const final;
+        rnd::sample::Dir::categoryProbability m) const final;
 
     void incrementCountsOf(
         State const* s,
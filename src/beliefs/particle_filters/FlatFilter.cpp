@@ -39,7 +39,7 @@ template<typename Deallocator>
 void FlatFilter<T>::replace(T replacement, Deallocator const& dealloc)
 {
     // we want to replace randomly
-    auto i = _distr(rnd::rng());
+    auto i = rnd::draw(_distr);
 
     dealloc(_particles[i]);
     _particles[i] = replacement;
@@ -96,7 +96,7 @@ std::string FlatFilter<T>::toString() const
 template<typename T>
 T FlatFilter<T>::sample() const
 {
-    auto const particle = _particles[_distr(rnd::rng())];
+    auto const particle = _particles[rnd::draw(_distr)];
 
     return particle;
 }
@@ -48,7 +48,7 @@ private:
     std::vector<T> _particles = {};
 
     // random number generator used to sample
-    mutable std::uniform_int_distribution<int> _distr = std::uniform_int_distribution<int>(0, 0);
+    std::uniform_int_distribution<int> _distr = std::uniform_int_distribution<int>(0, 0);
 };
 
 #include "FlatFilter.cpp"
@@ -4,7 +4,9 @@
 #include "beliefs/Belief.hpp"
 
 #include <cstddef>
+#include <memory>
 #include <string>
+#include <vector>
 
 #include "easylogging++.h"
 
@@ -30,27 +32,30 @@ namespace importance_sampling {
 template<typename T>
 double update(WeightedFilter<T>& belief, Action const* a, Observation const* o, POMDP const& d)
 {
-    Observation const* tmp_observation(nullptr);
-    Reward r(0);
+    auto const n = belief.size();
+
+    // step all particles in one batch
+    std::vector<State const*> states(n);
+    for (size_t i = 0; i < n; ++i) { states[i] = belief.particle(i)->particle; }
+
+    std::vector<int> observations(n);
+    std::vector<double> rewards(n);
+    std::unique_ptr<bool[]> terminals(new bool[n]);
+
+    d.stepMany(states.data(), n, a, observations.data(), rewards.data(), terminals.get());
 
     double total_weight = 0;
-    for (size_t i = 0; i < belief.size(); ++i)
+    for (size_t i = 0; i < n; ++i)
     {
         auto p = belief.particle(i);
 
-        // required because ** cannot convert to each other
-        // would be nice if there was some sort of solution here
-        auto& s = reinterpret_cast<State const*&>(p->particle);
-
-        d.step(&s, a, &tmp_observation, &r);
+        p->particle = static_cast<T>(states[i]);
         p->w *= d.computeObservationProbability(o, a, p->particle);
 
         VLOG(4) << " sample " << i << " has now index " << p->particle->index()
                 << " and was assigned weight " << p->w;
 
         total_weight += p->w;
-
-        d.releaseObservation(tmp_observation);
     }
 
     VLOG(3) << "acquired total weight of " << total_weight << " after updating " << belief.size()
@@ -206,7 +206,8 @@ std::vector<int> WeightedFilter<T>::leastLikely(size_t n) const
 {
     assert(n < size());
 
-    static std::priority_queue<queue_elements, std::vector<queue_elements>, Less> q;
+    // local: beliefs are updated concurrently by the workers of a service
+    std::priority_queue<queue_elements, std::vector<queue_elements>, Less> q;
 
     size_t i = 0;
 
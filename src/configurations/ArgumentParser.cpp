@@ -43,6 +43,14 @@ void parse(int argc, char* argv[], po::options_description* descr, configuration
 
     // update verbosity of logging
     el::Loggers::setVerboseLevel(conf->verbose);
+
+    // the service replies on stdout, which is kept free of anything but errors
+    if (conf->service == "-")
+    {
+        el_conf.setGlobally(el::ConfigurationType::ToStandardOutput, "false");
+        el_conf.set(el::Level::Error, el::ConfigurationType::ToStandardOutput, "true");
+    }
+
     el::Loggers::reconfigureAllLoggers(el_conf);
 
     if (!conf->seed.empty())
@@ -24,6 +24,25 @@ void Conf::addOptions(boost::program_options::options_description* descr)
         po::value(&output_file)->default_value(output_file),
         "Verbose")
         (
+        "telemetry-file",
+        po::value(&telemetry_file)->default_value(telemetry_file),
+        "File to write the statistics of each planning call to (CSV, or JSON lines if it ends "
+        "with .jsonl or .json), disabled if empty")
+        (
+        "service",
+        po::value(&service)->default_value(service),
+        "Serve episode sessions instead of running the experiment: reads requests from stdin if "
+        "'-', otherwise from the connections to a Unix socket at the given path")
+        (
+        "service-workers",
+        po::value(&service_workers)->default_value(service_workers),
+        "The number of sessions the service plans for at the same time")
+        (
+        "pipeline-particles",
+        po::value(&pipeline_particles)->default_value(pipeline_particles),
+        "Overlap belief updates with planning: the planner starts searching from this many "
+        "particles updated from a snapshot of the belief, until the update is done (0 disables)")
+        (
         "runs",
         po::value(&num_runs)->default_value(num_runs),
         "Number of runs")
@@ -78,6 +97,21 @@ void Conf::validate() const
         throw error("please enter a number between 0 and 1 for the discount");
     }
 
+    if (pipeline_particles < 0)
+    {
+        throw error("please enter a non-negative number of pipeline particles");
+    }
+
+    if (service_workers < 1)
+    {
+        throw error("please enter a positive number of service workers");
+    }
+
+    if (!service.empty() && planner_conf.mcts_reuse_tree)
+    {
+        throw error("the service can not reuse trees, since sessions share planners");
+    }
+
     if (planner != "random" && planner != "ts" && planner != "po-uct")
     {
         throw error("Please enter a legit planner: random, ts or po-uct");
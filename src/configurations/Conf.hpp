@@ -22,6 +22,13 @@ struct Conf
     unsigned short verbose  = 0;
     std::string output_file = "results.txt";
 
+    std::string telemetry_file = "";
+
+    std::string service = "";
+    int service_workers = 1;
+
+    int pipeline_particles = 0;
+
     int num_runs    = 1;
     int horizon     = 10;
     double discount = .95;
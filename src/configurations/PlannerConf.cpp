@@ -21,7 +21,83 @@ void PlannerConf::addOptions(boost::program_options::options_description* descr)
         (
         "exploration-constant,u",
         po::value(&mcts_exploration_const)->default_value(mcts_exploration_const),
-        "The exploration constant used by UCB in PO-UCT");
+        "The exploration constant used by UCB in PO-UCT")
+        (
+        "mcts-threads",
+        po::value(&mcts_threads)->default_value(mcts_threads),
+        "The number of threads used by PO-UCT")
+        (
+        "mcts-time-ms",
+        po::value(&mcts_time_ms)->default_value(mcts_time_ms),
+        "The time (in milliseconds) PO-UCT is given per step: when positive it simulates until "
+        "this deadline instead of a fixed number of simulations")
+        (
+        "mcts-parallelization",
+        po::value(&mcts_parallelization)->default_value(mcts_parallelization),
+        "How the threads of PO-UCT search: 'root' (each thread builds its own tree) or 'tree' "
+        "(all threads search in the same tree)")
+        (
+        "mcts-reuse-tree",
+        po::bool_switch(&mcts_reuse_tree)->default_value(mcts_reuse_tree),
+        "Whether PO-UCT keeps the sub tree of the real action and observation for the next step")
+        (
+        "mcts-simulation-streams",
+        po::bool_switch(&mcts_simulation_streams)->default_value(mcts_simulation_streams),
+        "Whether each simulation of PO-UCT draws from its own random stream (derived from the "
+        "seed and its index), independent of the thread that runs it (cheap with the philox "
+        "RANDOM_ENGINE)")
+        (
+        "mcts-pw-k",
+        po::value(&mcts_pw_k)->default_value(mcts_pw_k),
+        "Observation progressive widening in PO-UCT: a chance node visited n times has at most "
+        "k * n^alpha children (disabled if 0)")
+        (
+        "mcts-pw-alpha",
+        po::value(&mcts_pw_alpha)->default_value(mcts_pw_alpha),
+        "The exponent alpha of observation progressive widening (see mcts-pw-k)")
+        (
+        "mcts-rollout",
+        po::value(&mcts_rollout)->default_value(mcts_rollout),
+        "How PO-UCT evaluates new leaves: 'random' (rollout with random actions), 'heuristic' "
+        "(rollout with the heuristic actions of the domain), 'truncated' (heuristic rollout of at "
+        "most mcts-rollout-depth steps followed by the heuristic value of the domain) or "
+        "'value-table' (look up the value of the state in mcts-value-table)")
+        (
+        "mcts-rollout-depth",
+        po::value(&mcts_rollout_depth)->default_value(mcts_rollout_depth),
+        "The number of steps of a 'truncated' rollout")
+        (
+        "mcts-value-table",
+        po::value(&mcts_value_table)->default_value(mcts_value_table),
+        "File with the value of each state (by index, separated by whitespace) for the "
+        "'value-table' rollout")
+        (
+        "mcts-transposition-size",
+        po::value(&mcts_transposition_size)->default_value(mcts_transposition_size),
+        "The number of entries in the transposition table of PO-UCT, which shares nodes that are "
+        "reached through the same last (mcts-transposition-steps) actions and observations "
+        "(disabled if 0)")
+        (
+        "mcts-transposition-steps",
+        po::value(&mcts_transposition_steps)->default_value(mcts_transposition_steps),
+        "The number of last (action, observation) pairs that identify a node in the transposition "
+        "table")
+        (
+        "mcts-max-nodes",
+        po::value(&mcts_max_nodes)->default_value(mcts_max_nodes),
+        "The maximum number of nodes in the tree(s) of PO-UCT: once reached the search stops "
+        "expanding and simulates through the existing tree (unlimited if 0)")
+        (
+        "mcts-max-bytes",
+        po::value(&mcts_max_bytes)->default_value(mcts_max_bytes),
+        "The maximum memory (in bytes) of the nodes in the tree(s) of PO-UCT, see mcts-max-nodes "
+        "(unlimited if 0)")
+        (
+        "mcts-early-stop-interval",
+        po::value(&mcts_early_stop_interval)->default_value(mcts_early_stop_interval),
+        "The number of simulations between checks whether the most visited action of PO-UCT can "
+        "still change with the remaining simulations, it stops early (and picks that action) if "
+        "not (disabled if 0)");
     // clang-format on
 }
 
@@ -43,6 +119,68 @@ void PlannerConf::validate() const
     {
         throw error("Please set a positive exploration constant");
     }
+
+    if (mcts_threads < 1)
+    {
+        throw error("Please set a positive number of threads");
+    }
+
+    if (mcts_time_ms < 0)
+    {
+        throw error("Please set a positive PO-UCT time budget (or 0 to use the simulation amount)");
+    }
+
+    if (mcts_parallelization != "root" && mcts_parallelization != "tree")
+    {
+        throw error("Please set the MCTS parallelization to 'root' or 'tree'");
+    }
+
+    if (mcts_pw_k < 0)
+    {
+        throw error("Please set a positive progressive widening k (or 0 to disable it)");
+    }
+
+    if (mcts_pw_alpha < 0 || mcts_pw_alpha > 1)
+    {
+        throw error("Please set the progressive widening alpha between 0 and 1");
+    }
+
+    if (mcts_rollout != "random" && mcts_rollout != "heuristic" && mcts_rollout != "truncated"
+        && mcts_rollout != "value-table")
+    {
+        throw error("Please set the MCTS rollout to 'random', 'heuristic', 'truncated' or "
+                    "'value-table'");
+    }
+
+    if (mcts_rollout_depth < 0)
+    {
+        throw error("Please set a positive rollout depth");
+    }
+
+    if (mcts_transposition_size < 0)
+    {
+        throw error("Please set a positive transposition table size (or 0 to disable it)");
+    }
+
+    if (mcts_transposition_steps < 1)
+    {
+        throw error("Please set the number of transposition steps to at least 1");
+    }
+
+    if (mcts_max_nodes < 0 || mcts_max_bytes < 0)
+    {
+        throw error("Please set a positive maximum number of nodes and bytes (or 0 for no limit)");
+    }
+
+    if (mcts_early_stop_interval < 0)
+    {
+        throw error("Please set a positive early stop interval (or 0 to disable it)");
+    }
+
+    if (mcts_rollout == "value-table" && mcts_value_table.empty())
+    {
+        throw error("Please provide a value table (mcts-value-table) for 'value-table' rollouts");
+    }
 }
 
 } // namespace configurations
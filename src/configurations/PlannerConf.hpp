@@ -16,6 +16,23 @@ struct PlannerConf
     int mcts_simulation_amount    = 1000;
     int mcts_max_depth            = -1;
     double mcts_exploration_const = 100;
+    int mcts_threads              = 1;
+    int mcts_time_ms              = 0;
+    double mcts_pw_k              = 0;
+    double mcts_pw_alpha          = .5;
+    int mcts_rollout_depth        = 10;
+    int mcts_transposition_size   = 0;
+    int mcts_transposition_steps  = 2;
+    int mcts_max_nodes            = 0;
+    long mcts_max_bytes           = 0;
+    int mcts_early_stop_interval  = 0;
+
+    std::string mcts_parallelization = "root";
+    std::string mcts_rollout         = "random";
+    std::string mcts_value_table     = "";
+
+    bool mcts_reuse_tree         = false;
+    bool mcts_simulation_streams = false;
 
     /**
      * /brief adds options in this structure to descr
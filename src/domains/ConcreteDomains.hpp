@@ -0,0 +1,87 @@
+#ifndef CONCRETEDOMAINS_HPP
+#define CONCRETEDOMAINS_HPP
+
+#include <typeinfo>
+
+#include "domains/POMDP.hpp"
+#include "domains/agr/AGR.hpp"
+#include "domains/coffee/CoffeeProblem.hpp"
+#include "domains/collision-avoidance/CollisionAvoidance.hpp"
+#include "domains/dummy/DummyDomain.hpp"
+#include "domains/dummy/FactoredDummyDomain.hpp"
+#include "domains/dummy/LinearDummyDomain.hpp"
+#include "domains/gridworld/GridWorld.hpp"
+#include "domains/sysadmin/SysAdmin.hpp"
+#include "domains/tiger/FactoredTiger.hpp"
+#include "domains/tiger/Tiger.hpp"
+
+namespace factory {
+
+/**
+ * @brief calls `f` with the domain cast to its type, if that is one of `Domains`
+ *
+ * `Domains` are compared against the exact (dynamic) type of the domain.
+ * Other domains are passed to `f` as `POMDP`.
+ **/
+template<typename... Domains>
+struct ConcreteDomains;
+
+template<>
+struct ConcreteDomains<>
+{
+    template<typename F>
+    static auto call(POMDP const& domain, F const& f) -> decltype(f(domain))
+    {
+        return f(domain);
+    }
+};
+
+template<typename Domain, typename... Domains>
+struct ConcreteDomains<Domain, Domains...>
+{
+    template<typename F>
+    static auto call(POMDP const& domain, F const& f) -> decltype(f(domain))
+    {
+        if (typeid(domain) == typeid(Domain))
+        {
+            return f(static_cast<Domain const&>(domain));
+        }
+
+        return ConcreteDomains<Domains...>::call(domain, f);
+    }
+};
+
+/**
+ * @brief the types of the domains `makePOMDP` creates
+ *
+ * Kept in sync with `makeEnvironment`
+ **/
+using MadeDomains = ConcreteDomains<
+    domains::AGR,
+    domains::CoffeeProblem,
+    domains::CollisionAvoidance,
+    domains::DummyDomain,
+    domains::FactoredDummyDomain,
+    domains::FactoredTiger,
+    domains::GridWorld,
+    domains::LinearDummyDomain,
+    domains::SysAdmin,
+    domains::Tiger>;
+
+/**
+ * @brief calls `f` with `domain` as its concrete type, if it is a domain `makePOMDP` creates
+ *
+ * `f` must accept any domain type (e.g. through a templated call
+ * operator), and is instantiated for each of them. This allows templated
+ * code to call the (final) functions of the domain directly, instead of
+ * through the virtual table. Domains of other types are passed as `POMDP`.
+ **/
+template<typename F>
+auto withConcreteDomain(POMDP const& domain, F const& f) -> decltype(f(domain))
+{
+    return MadeDomains::call(domain, f);
+}
+
+} // namespace factory
+
+#endif // CONCRETEDOMAINS_HPP
@@ -1,6 +1,40 @@
 #include "POMDP.hpp"
 
 #include "configurations/DomainConf.hpp"
+#include "environment/Observation.hpp"
+#include "environment/Reward.hpp"
+#include "environment/Terminal.hpp"
+
+Action const* POMDP::generateHeuristicAction(State const* s) const
+{
+    return generateRandomAction(s);
+}
+
+double POMDP::heuristicValue(State const* /*s*/, int /*steps_to_go*/) const
+{
+    return 0;
+}
+
+void POMDP::stepMany(
+    State const** states,
+    size_t n,
+    Action const* a,
+    int* observations,
+    double* rewards,
+    bool* terminals) const
+{
+    Observation const* o(nullptr);
+    Reward r(0);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        terminals[i]    = step(&states[i], a, &o, &r).terminated();
+        observations[i] = o->index();
+        rewards[i]      = r.toDouble();
+
+        releaseObservation(o);
+    }
+}
 
 namespace factory {
 
@@ -3,6 +3,7 @@
 
 #include "environment/Environment.hpp"
 
+#include <cstddef>
 #include <memory>
 #include <vector>
 
@@ -57,6 +58,46 @@ public:
      **/
     virtual void addLegalActions(State const* s, std::vector<Action const*>* actions) const = 0;
 
+    /**
+     * @brief returns a (cheap) heuristic action to take in state s
+     *
+     * Planners may use this to roll out with: domains that have some
+     * structure to exploit can override this to guide rollouts towards
+     * sensible behaviour. Returns a random action by default.
+     *
+     * Do not forget to `releaseAction` on the result when done
+     **/
+    virtual Action const* generateHeuristicAction(State const* s) const;
+
+    /**
+     * @brief returns a (cheap) estimate of the return in s with `steps_to_go` steps left
+     *
+     * Planners may use this to evaluate the state at which they stop
+     * simulating. Returns 0 by default.
+     **/
+    virtual double heuristicValue(State const* s, int steps_to_go) const;
+
+    /**
+     * @brief steps a batch of `n` states with action a
+     *
+     * The batched version of `step`: each `states[i]` is replaced by its next
+     * state (as `step` does), and the index of the generated observation,
+     * the reward and whether the step terminated are written in
+     * `observations[i]`, `rewards[i]` and `terminals[i]`. Observations are
+     * returned as indices, so no `Observation` has to be released.
+     *
+     * The default implementation loops over `step`. Domains that allocate
+     * their states up front override this with a loop over state indices
+     * that avoids the per-state virtual calls and observation handling.
+     **/
+    virtual void stepMany(
+        State const** states,
+        size_t n,
+        Action const* a,
+        int* observations,
+        double* rewards,
+        bool* terminals) const;
+
     /**** functions required by beliefs ****/
 
     /**
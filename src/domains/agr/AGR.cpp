@@ -235,13 +235,13 @@ AGR::~AGR()
 
 State const* AGR::sampleStartState() const
 {
-    return _start_states[_start_state_distr(rnd::rng())];
+    return _start_states[rnd::draw(_start_state_distr)];
 }
 
 Action const* AGR::generateRandomAction(State const* s) const
 {
     legalStateCheck(s);
-    return _actions[_action_distr(rnd::rng())];
+    return _actions[rnd::draw(_action_distr)];
 }
 
 Terminal AGR::step(State const** s, Action const* a, Observation const** o, Reward* r) const
@@ -106,23 +106,22 @@ public:
     AGR(AGR const&) = default;
     AGR& operator=(AGR const&) = default;
 
-    State const* sampleStartState() const override;
-    Action const* generateRandomAction(State const* s) const override;
-    Terminal
-        step(State const** s, Action const* a, Observation const** o, Reward* r) const override;
+    State const* sampleStartState() const final;
+    Action const* generateRandomAction(State const* s) const final;
+    Terminal step(State const** s, Action const* a, Observation const** o, Reward* r) const final;
 
     double computeObservationProbability(Observation const* o, Action const* a, State const* s)
         const final;
 
-    void addLegalActions(State const* s, std::vector<Action const*>* actions) const override;
+    void addLegalActions(State const* s, std::vector<Action const*>* actions) const final;
 
-    void releaseAction(Action const* a) const override;
-    void releaseObservation(Observation const* o) const override;
-    void releaseState(State const* s) const override;
+    void releaseAction(Action const* a) const final;
+    void releaseObservation(Observation const* o) const final;
+    void releaseState(State const* s) const final;
 
-    Action const* copyAction(Action const* a) const override;
-    Observation const* copyObservation(Observation const* o) const override;
-    State const* copyState(State const* s) const override;
+    Action const* copyAction(Action const* a) const final;
+    Observation const* copyObservation(Observation const* o) const final;
+    State const* copyState(State const* s) const final;
 
     int _n;
 
@@ -131,13 +130,13 @@ public:
 
     int _nstart_states;
     AGRState const** _start_states;
-    // cannot generate when const...
-    mutable std::uniform_int_distribution<int> _start_state_distr;
+    // drawn from with `rnd::draw`
+    std::uniform_int_distribution<int> _start_state_distr;
 
     int _nactions;
     AGRAction const** _actions;
-    // cannot generate when const...
-    mutable std::uniform_int_distribution<int> _action_distr;
+    // drawn from with `rnd::draw`
+    std::uniform_int_distribution<int> _action_distr;
 
     int _nobservations;
     AGRObservation const** _observations;
@@ -66,7 +66,7 @@ double CoffeeProblem::computeObservationProbability(
 
 State const* CoffeeProblem::sampleStartState() const
 {
-    return _states.get(_state_distr(rnd::rng()));
+    return _states.get(rnd::draw(_state_distr));
 }
 
 Terminal
@@ -78,8 +78,8 @@ private:
     utils::DiscreteSpace<CoffeeProblemAction> _actions;
     utils::DiscreteSpace<CoffeeProblemObservation> _observations;
 
-    mutable std::uniform_int_distribution<int> _state_distr =
-        rnd::integerDistribution(0, _S); // cannot generate when const...
+    std::uniform_int_distribution<int> _state_distr =
+        rnd::integerDistribution(0, _S); // drawn from with `rnd::draw`
 
     /***  performs some assertions  to check validity ***/
     void assertLegal(State const* s) const;
@@ -214,6 +214,44 @@ void CollisionAvoidance::addLegalActions(State const* s, std::vector<Action cons
     for (auto i = 0; i < NUM_ACTIONS; ++i) { actions->emplace_back(_actions.get(i)); }
 }
 
+Action const* CollisionAvoidance::generateHeuristicAction(State const* s) const
+{
+    assertLegal(s);
+
+    auto const x_agent = xAgent(s);
+    auto const y_agent = yAgent(s);
+
+    // the obstacle in the next column, or the closest one if further away
+    auto const y_obstacle = yObstacles(s)[std::max(0, std::min(x_agent, _num_obstacles) - 1)];
+
+    if (std::abs(y_agent - y_obstacle) > 1)
+    {
+        return getAction(STAY);
+    }
+
+    // move away from the obstacle, unless the grid does not allow it
+    auto const away = (y_agent > y_obstacle || (y_agent == y_obstacle && y_agent == 0))
+                          ? MOVE_UP
+                          : MOVE_DOWN;
+
+    return getAction((keepInGrid(y_agent + away - 1) == y_agent) ? STAY : away);
+}
+
+double CollisionAvoidance::heuristicValue(State const* s, int steps_to_go) const
+{
+    assertLegal(s);
+
+    if (steps_to_go <= 0 || xAgent(s) == 0)
+    {
+        return 0;
+    }
+
+    auto const y_obstacle = yObstacles(s)[std::max(0, std::min(xAgent(s), _num_obstacles) - 1)];
+
+    // number of moves until the obstacle can no longer reach the agent in one step
+    return -MOVE_PENALTY * std::max(0, 2 - std::abs(yAgent(s) - y_obstacle));
+}
+
 double CollisionAvoidance::computeObservationProbability(
     Observation const* o,
     Action const* /*a*/,
@@ -254,7 +292,7 @@ Terminal
     // generate observation
     for (auto& b : blocks)
     {
-        auto observation_noise = static_cast<int>(std::round(_observation_distr(rnd::rng())));
+        auto observation_noise = static_cast<int>(std::round(rnd::normal::sample(0, 1)));
         b                      = keepInGrid(b + observation_noise);
     }
     *o = _observations[indexing::project(blocks, _obstacles_space)];
@@ -269,6 +307,52 @@ Terminal
     return Terminal(crashed || xAgent(*s) == 0);
 }
 
+void CollisionAvoidance::stepMany(
+    State const** states,
+    size_t n,
+    Action const* a,
+    int* observations,
+    double* rewards,
+    bool* terminals) const
+{
+    assertLegal(a);
+
+    auto const move_penalty = a->index() == STAY ? 0 : -MOVE_PENALTY;
+
+    // positions of the obstacles, re-used over all states
+    std::vector<int> blocks(_num_obstacles);
+
+    // same as `step`, but on the features of the states
+    for (size_t i = 0; i < n; ++i)
+    {
+        assertLegal(states[i]);
+
+        auto const* collision_state = static_cast<CollisionAvoidanceState const*>(states[i]);
+
+        auto const x = collision_state->x_agent - 1;
+        auto const y = keepInGrid(collision_state->y_agent + a->index() - 1);
+
+        for (auto b = 0; b < _num_obstacles; ++b)
+        {
+            blocks[b] = moveObstacle(collision_state->obstacles_pos[b]);
+        }
+
+        states[i] = _states[x][y][indexing::project(blocks, _obstacles_space)];
+
+        auto const crashed = x < _num_obstacles && y == blocks[x];
+
+        for (auto& b : blocks)
+        {
+            auto observation_noise = static_cast<int>(std::round(rnd::normal::sample(0, 1)));
+            b                      = keepInGrid(b + observation_noise);
+        }
+
+        observations[i] = indexing::project(blocks, _obstacles_space);
+        rewards[i]      = crashed ? -COLLIDE_PENALTY : move_penalty;
+        terminals[i]    = crashed || x == 0;
+    }
+}
+
 State const* CollisionAvoidance::sampleStartState() const
 {
     return getState(_state_prior.sample());
@@ -298,7 +382,7 @@ Observation const* CollisionAvoidance::getObservation(int y) const
 Action const* CollisionAvoidance::generateRandomAction(State const* /*s*/) const
 {
     // any action (up, stay, down) is possible in any state
-    return getAction(move(_action_distr(rnd::rng())));
+    return getAction(move(rnd::draw(_action_distr)));
 }
 
 void CollisionAvoidance::releaseAction(Action const* a) const
@@ -121,6 +121,33 @@ public:
     /***** domain interface ****/
     Action const* generateRandomAction(State const* s) const final;
     void addLegalActions(State const* s, std::vector<Action const*>* actions) const final;
+
+    /**
+     * @brief moves away from the next obstacle when it is (almost) in line, stays otherwise
+     **/
+    Action const* generateHeuristicAction(State const* s) const final;
+
+    /**
+     * @brief returns the (move) penalty of getting out of line of the next obstacle
+     *
+     * Optimistically assumes the agent manages to dodge the obstacle.
+     **/
+    double heuristicValue(State const* s, int steps_to_go) const final;
+
+    /**
+     * @brief steps all states with a single buffer for the obstacle positions
+     *
+     * Unlike `step`, which copies the obstacles of each state, this
+     * does not allocate per state.
+     **/
+    void stepMany(
+        State const** states,
+        size_t n,
+        Action const* a,
+        int* observations,
+        double* rewards,
+        bool* terminals) const final;
+
     double computeObservationProbability(Observation const* o, Action const* a, State const* new_s)
         const final;
 
@@ -160,16 +187,9 @@ private:
     std::vector<double> _observation_error_probability{};
 
     // uniform distriution over the actions
-    mutable std::uniform_int_distribution<int> _action_distr{
+    std::uniform_int_distribution<int> _action_distr{
         rnd::integerDistribution(0, NUM_ACTIONS)};
 
-    // describes the noise of the observation
-    mutable std::normal_distribution<float> _observation_distr =
-        std::normal_distribution<float>(0, 1);
-
-    mutable std::uniform_int_distribution<int> _y_sampler{
-        rnd::integerDistribution(0, _grid_height)};
-
     utils::categoricalDistr _state_prior{static_cast<size_t>(
         _grid_width * _grid_height * static_cast<int>(std::pow(_grid_height, _num_obstacles)))};
 
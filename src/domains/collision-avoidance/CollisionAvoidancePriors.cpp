@@ -475,8 +475,8 @@ bayes_adaptive::factored::BABNModel::Structure CollisionAvoidanceFactoredPrior::
 
     // the structure noise in this problem is the transition
     // function of the obstacle for each action. Here we pick which to change
-    auto const a  = _action_distr(rnd::rng());
-    auto obstacle = 2 + _obst_distr(rnd::rng());
+    auto const a  = rnd::draw(_action_distr);
+    auto obstacle = 2 + rnd::draw(_obst_distr);
 
     // then we just flip an edge in that structure
     bayes_adaptive::factored::BABNModel::Structure::flip_random_edge(
@@ -111,9 +111,9 @@ private:
     bayes_adaptive::factored::BABNModel::Indexing_Steps const _fbapomdp_step_size;
 
     // samples obstacles
-    mutable std::uniform_int_distribution<int> _action_distr{
+    std::uniform_int_distribution<int> _action_distr{
         rnd::integerDistribution(0, _NUM_ACTIONS)};
-    mutable std::uniform_int_distribution<int> _obst_distr{
+    std::uniform_int_distribution<int> _obst_distr{
         rnd::integerDistribution(0, _num_obstacles)};
 
     std::vector<DBNNode> _observation_model = {}, _correctly_connected_transition_model = {},
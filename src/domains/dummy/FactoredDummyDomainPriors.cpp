@@ -117,8 +117,8 @@ void FactoredDummyPrior::precomputePrior()
 
         // going up gets +1 unless on top edge already
         temp_next_state.index(i + ((((i + 1) % _size) != 0u) ? 1 : 0));
-        s.model()->count(&temp_state, &up, &temp_next_state)++;
-        s.model()->count(&up, &temp_next_state, &o)++;
+        s.model()->count(&temp_state, &up, &temp_next_state) += 1;
+        s.model()->count(&up, &temp_next_state, &o) += 1;
 
         s_factored.incrementCountsOf(&temp_state, &up, &o, &temp_next_state);
         s_fact_fully_connected.incrementCountsOf(&temp_state, &up, &o, &temp_next_state);
@@ -126,8 +126,8 @@ void FactoredDummyPrior::precomputePrior()
         // going right +_size unless on right edge already
         temp_next_state.index(
             i + ((i < static_cast<int>((_size - 1) * _size)) ? static_cast<int>(_size) : 0));
-        s.model()->count(&temp_state, &right, &temp_next_state)++;
-        s.model()->count(&right, &temp_next_state, &o)++;
+        s.model()->count(&temp_state, &right, &temp_next_state) += 1;
+        s.model()->count(&right, &temp_next_state, &o) += 1;
 
         s_factored.incrementCountsOf(&temp_state, &right, &o, &temp_next_state);
         s_fact_fully_connected.incrementCountsOf(&temp_state, &right, &o, &temp_next_state);
@@ -231,6 +231,51 @@ void GridWorld::addLegalActions(State const* s, std::vector<Action const*>* acti
     for (auto a = 0; a < _A_size; ++a) { actions->emplace_back(new GridWorldAction(a)); }
 }
 
+Action const* GridWorld::generateHeuristicAction(State const* s) const
+{
+    assertLegal(s);
+
+    auto const& agent_pos = static_cast<GridWorldState const*>(s)->_agent_position;
+    auto const& goal_pos  = static_cast<GridWorldState const*>(s)->_goal_position;
+
+    // the moves that bring the agent closer to the goal
+    int moves[2];
+    auto num_moves = 0;
+
+    if (agent_pos.x != goal_pos.x)
+    {
+        moves[num_moves++] =
+            (agent_pos.x < goal_pos.x) ? GridWorldAction::RIGHT : GridWorldAction::LEFT;
+    }
+
+    if (agent_pos.y != goal_pos.y)
+    {
+        moves[num_moves++] =
+            (agent_pos.y < goal_pos.y) ? GridWorldAction::UP : GridWorldAction::DOWN;
+    }
+
+    if (num_moves == 0)
+    {
+        return generateRandomAction(s);
+    }
+
+    return new GridWorldAction(moves[rnd::slowRandomInt(0, num_moves)]);
+}
+
+double GridWorld::heuristicValue(State const* s, int steps_to_go) const
+{
+    assertLegal(s);
+
+    auto const& agent_pos = static_cast<GridWorldState const*>(s)->_agent_position;
+    auto const& goal_pos  = static_cast<GridWorldState const*>(s)->_goal_position;
+
+    // the reward is given in the step *after* reaching the goal
+    auto const distance = std::abs(static_cast<int>(agent_pos.x) - static_cast<int>(goal_pos.x))
+                          + std::abs(static_cast<int>(agent_pos.y) - static_cast<int>(goal_pos.y));
+
+    return (distance < steps_to_go) ? goal_reward : step_reward;
+}
+
 double GridWorld::computeObservationProbability(
     Observation const* o,
     Action const* a,
@@ -303,6 +348,43 @@ Terminal GridWorld::step(State const** s, Action const* a, Observation const** o
     return Terminal(found_goal);
 }
 
+void GridWorld::stepMany(
+    State const** states,
+    size_t n,
+    Action const* a,
+    int* observations,
+    double* rewards,
+    bool* terminals) const
+{
+    assertLegal(a);
+
+    // same as `step`, but returns observation indices
+    for (size_t i = 0; i < n; ++i)
+    {
+        assertLegal(states[i]);
+
+        auto grid_state       = static_cast<GridWorldState const*>(states[i]);
+        auto const& agent_pos = grid_state->_agent_position;
+        auto const& goal_pos  = grid_state->_goal_position;
+
+        bool const move_succeeds = (agentOnSlowLocation(agent_pos))
+                                       ? (rnd::uniform_rand01() < slow_move_prob)
+                                       : (rnd::uniform_rand01() < move_prob);
+
+        auto const new_agent_pos = (move_succeeds) ? applyMove(agent_pos, a) : agent_pos;
+
+        auto const found_goal   = foundGoal(grid_state);
+        auto const new_goal_pos = (found_goal)
+                                      ? _goal_locations[rnd::slowRandomInt(0, _goal_amount)]
+                                      : goal_pos;
+
+        states[i]       = &_S[positionsToIndex(new_agent_pos, new_goal_pos)];
+        observations[i] = generateObservation(new_agent_pos, new_goal_pos)->index();
+        rewards[i]      = found_goal ? goal_reward : step_reward;
+        terminals[i]    = found_goal;
+    }
+}
+
 void GridWorld::releaseObservation(Observation const* o) const
 {
     assertLegal(o);
@@ -160,6 +160,25 @@ public:
     /**** POMDP interface ****/
     Action const* generateRandomAction(State const* s) const final;
     void addLegalActions(State const* s, std::vector<Action const*>* actions) const final;
+
+    /**
+     * @brief returns a random move towards the goal (or any move when on it)
+     **/
+    Action const* generateHeuristicAction(State const* s) const final;
+
+    /**
+     * @brief returns the goal reward if the goal can be reached within `steps_to_go` moves
+     **/
+    double heuristicValue(State const* s, int steps_to_go) const final;
+
+    void stepMany(
+        State const** states,
+        size_t n,
+        Action const* a,
+        int* observations,
+        double* rewards,
+        bool* terminals) const final;
+
     double computeObservationProbability(Observation const* o, Action const* a, State const* new_s)
         const final;
     void releaseAction(Action const* a) const final;
@@ -151,6 +151,65 @@ Terminal SysAdmin::step(State const** s, Action const* a, Observation const** o,
     return Terminal(false);
 }
 
+void SysAdmin::stepMany(
+    State const** states,
+    size_t n,
+    Action const* a,
+    int* observations,
+    double* rewards,
+    bool* terminals) const
+{
+    assertLegal(a);
+
+    auto const rebooting         = isRebootingAction(a);
+    auto const operated_computer = (rebooting) ? a->index() - _size : a->index();
+    auto const cost              = param._reboot_cost * static_cast<int>(rebooting);
+
+    // the probability of a computer to keep running given its number of failing neighbours
+    double keeps_running_prob[3];
+    for (auto f = 0; f < 3; ++f)
+    {
+        keeps_running_prob[f] = (1 - param._fail_prob) * pow(1 - param._fail_neighbour_factor, f);
+    }
+
+    // same as `step`, but on the bits of the state indices
+    for (size_t i = 0; i < n; ++i)
+    {
+        assertLegal(states[i]);
+
+        auto const old_index = states[i]->index();
+
+        auto index = old_index;
+        for (auto c = 0; c < _size; ++c)
+        {
+            auto failing_neighbours = 0;
+            if (_version == LINEAR)
+            {
+                failing_neighbours += (c > 0 && !(old_index & (0x1 << (c - 1))));
+                failing_neighbours += (c < (_size - 1) && !(old_index & (0x1 << (c + 1))));
+            }
+
+            if (rnd::uniform_rand01() > keeps_running_prob[failing_neighbours])
+            {
+                index = index & ~(0x1 << c);
+            }
+        }
+
+        if (rebooting && rnd::uniform_rand01() < param._reboot_success_rate)
+        {
+            index = index | (0x1 << operated_computer);
+        }
+
+        auto const is_operational     = (index & (0x1 << operated_computer)) != 0;
+        auto const observed_correctly = rnd::uniform_rand01() < param._observe_prob;
+
+        states[i]       = &_states[index];
+        observations[i] = (observed_correctly == is_operational) ? OPERATIONAL : FAILING;
+        rewards[i]      = static_cast<float>(_states[index].numOperationalComputers()) - cost;
+        terminals[i]    = false;
+    }
+}
+
 double SysAdmin::computeObservationProbability(
     Observation const* o,
     Action const* a,
@@ -167,7 +226,7 @@ double SysAdmin::computeObservationProbability(
 
 Action const* SysAdmin::generateRandomAction(State const* /*s*/) const
 {
-    return _actions.get(_action_distr(rnd::rng()));
+    return _actions.get(rnd::draw(_action_distr));
 }
 
 void SysAdmin::addLegalActions(State const* s, std::vector<Action const*>* actions) const
@@ -115,6 +115,13 @@ public:
     void addLegalActions(State const* s, std::vector<Action const*>* actions) const final;
     double computeObservationProbability(Observation const* o, Action const* a, State const* new_s)
         const final;
+    void stepMany(
+        State const** states,
+        size_t n,
+        Action const* a,
+        int* observations,
+        double* rewards,
+        bool* terminals) const final;
 
 private:
     NETWORK_TOPOLOGY _version;
@@ -132,8 +139,8 @@ private:
     utils::DiscreteSpace<IndexAction> _actions{_A_size};
     std::vector<SysAdminState> _states;
 
-    // mutable because generating actually modifies the distr
-    mutable std::uniform_int_distribution<int> _action_distr{rnd::integerDistribution(0, _A_size)};
+    // drawn from with `rnd::draw`, which does not modify (the shared) distribution
+    std::uniform_int_distribution<int> _action_distr{rnd::integerDistribution(0, _A_size)};
 
     /**
      * @brief returns whether this action is rebooting action
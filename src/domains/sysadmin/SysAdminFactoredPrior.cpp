@@ -49,7 +49,7 @@ bayes_adaptive::factored::BABNModel::Structure
 {
 
     bayes_adaptive::factored::BABNModel::Structure::flip_random_edge(
-        &structure.T[_action_distr(rnd::rng())][_comp_distr(rnd::rng())], _comp_distr.max() + 1);
+        &structure.T[rnd::draw(_action_distr)][rnd::draw(_comp_distr)], _comp_distr.max() + 1);
 
     return structure;
 }
@@ -49,8 +49,8 @@ private:
     Domain_Feature_Size const _domain_feature_size;
     bayes_adaptive::factored::BABNModel::BABNModel::Indexing_Steps const _fbapomdp_step_size;
 
-    mutable std::uniform_int_distribution<int> _action_distr;
-    mutable std::uniform_int_distribution<int> _comp_distr;
+    std::uniform_int_distribution<int> _action_distr;
+    std::uniform_int_distribution<int> _comp_distr;
 
     std::vector<DBNNode> _fully_connected_transition_nodes = {};
     std::vector<DBNNode> _prior_transition_nodes           = {};
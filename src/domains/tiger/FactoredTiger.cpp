@@ -30,7 +30,7 @@ FactoredTiger::TigerLocation FactoredTiger::tigerLocation(State const* s) const
 
 Action const* FactoredTiger::generateRandomAction(State const* /*s*/) const
 {
-    return _actions.get(_action_distr(rnd::rng()));
+    return _actions.get(rnd::draw(_action_distr));
 }
 
 void FactoredTiger::addLegalActions(State const* /*s*/, std::vector<Action const*>* actions) const
@@ -71,7 +71,7 @@ double FactoredTiger::computeObservationProbability(
 State const* FactoredTiger::sampleStartState() const
 {
     // any state is a legit start state
-    return _states.get(_state_distr(rnd::rng()));
+    return _states.get(rnd::draw(_state_distr));
 }
 
 Terminal
@@ -121,6 +121,46 @@ Terminal
         a->index() != TigerAction::OBSERVE && _type == FactoredTigerDomainType::EPISODIC);
 }
 
+void FactoredTiger::stepMany(
+    State const** states,
+    size_t n,
+    Action const* a,
+    int* observations,
+    double* rewards,
+    bool* terminals) const
+{
+    assertLegal(a);
+
+    auto const terminates =
+        a->index() != TigerAction::OBSERVE && _type == FactoredTigerDomainType::EPISODIC;
+
+    // same as `step`, but on indices
+    for (size_t i = 0; i < n; ++i)
+    {
+        assertLegal(states[i]);
+
+        auto const tiger = (states[i]->index() < _S_size / 2) ? LEFT : RIGHT;
+
+        if (a->index() == TigerAction::OBSERVE)
+        {
+            rewards[i] = -1;
+
+            // hear right if correct xor tiger is left (see `step`)
+            auto const correct_observation = rnd::uniform_rand01() < .85;
+            auto const hear_right          = correct_observation == (tiger == RIGHT);
+
+            observations[i] = hear_right ? RIGHT : LEFT;
+        } else
+        {
+            rewards[i]      = (a->index() == tiger) ? 10 : -100;
+            observations[i] = (rnd::boolean()) ? LEFT : RIGHT;
+            states[i]       = _states.get(rnd::draw(_state_distr));
+        }
+
+        terminals[i] = terminates;
+    }
+}
+
 void FactoredTiger::releaseObservation(Observation const* o) const
 {
     assertLegal(o);
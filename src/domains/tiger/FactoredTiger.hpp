@@ -52,6 +52,13 @@ public:
     Action const* copyAction(Action const* a) const final;
     double computeObservationProbability(Observation const* o, Action const* a, State const* new_s)
         const final;
+    void stepMany(
+        State const** states,
+        size_t n,
+        Action const* a,
+        int* observations,
+        double* rewards,
+        bool* terminals) const final;
 
     /**** Environment interface ****/
     State const* sampleStartState() const final;
@@ -74,8 +81,8 @@ private:
     std::vector<IndexObservation> _observations{_hear_left, _hear_right};
 
     // used to sample states uniformly
-    mutable std::uniform_int_distribution<int> _state_distr{0, _S_size - 1};
-    mutable std::uniform_int_distribution<int> _action_distr{0, _A_size - 1};
+    std::uniform_int_distribution<int> _state_distr{0, _S_size - 1};
+    std::uniform_int_distribution<int> _action_distr{0, _A_size - 1};
 
     /**** checks for legal input *****/
     void assertLegal(State const* s) const;
@@ -21,7 +21,7 @@ State const* Tiger::sampleStartState() const
 Action const* Tiger::generateRandomAction(State const* s) const
 {
     legalStateCheck(s);
-    return _actions.get(_action_distr(rnd::rng()));
+    return _actions.get(rnd::draw(_action_distr));
 }
 
 double Tiger::computeObservationProbability(Observation const* o, Action const* a, State const* s)
@@ -81,6 +81,45 @@ Terminal Tiger::step(State const** s, Action const* a, Observation const** o, Re
     return Terminal(_type == EPISODIC && a->index() != OBSERVE);
 }
 
+void Tiger::stepMany(
+    State const** states,
+    size_t n,
+    Action const* a,
+    int* observations,
+    double* rewards,
+    bool* terminals) const
+{
+    legalActionCheck(a);
+
+    auto const terminates = _type == EPISODIC && a->index() != OBSERVE;
+
+    // same as `step`, but on indices
+    for (size_t i = 0; i < n; ++i)
+    {
+        legalStateCheck(states[i]);
+
+        auto const tiger = states[i]->index();
+
+        if (a->index() == Literal::OBSERVE)
+        {
+            rewards[i] = -1;
+
+            // hear right if correct xor tiger is left (see `step`)
+            auto const correct_observation = rnd::uniform_rand01() < .85;
+            auto const hear_right          = correct_observation == (tiger == Literal::RIGHT);
+
+            observations[i] = hear_right ? Literal::RIGHT : Literal::LEFT;
+        } else
+        {
+            rewards[i]      = (a->index() == tiger) ? 10 : -100;
+            observations[i] = static_cast<int>(rnd::boolean());
+            states[i]       = _states.get(static_cast<int>(rnd::boolean()));
+        }
+
+        terminals[i] = terminates;
+    }
+}
+
 void Tiger::addLegalActions(State const* s, std::vector<Action const*>* actions) const
 {
     assert(actions->empty());
@@ -46,6 +46,13 @@ public:
     /*** domain interface ***/
     void addLegalActions(State const* s, std::vector<Action const*>* actions) const final;
     Action const* generateRandomAction(State const* s) const final;
+    void stepMany(
+        State const** states,
+        size_t n,
+        Action const* a,
+        int* observations,
+        double* rewards,
+        bool* terminals) const final;
 
     double computeObservationProbability(Observation const* o, Action const* a, State const* s)
         const final;
@@ -62,7 +69,7 @@ private:
     utils::DiscreteSpace<IndexState> _states{2};
     utils::DiscreteSpace<IndexObservation> _observations{2};
 
-    mutable std::uniform_int_distribution<int> _action_distr{0, 2}; // cannot generate when const...
+    std::uniform_int_distribution<int> _action_distr{0, 2}; // drawn from with `rnd::draw`
 
     /*** assertion functions **/
     void legalActionCheck(Action const* a) const;
@@ -14,6 +14,7 @@
 
 namespace factory {
 
+// the types of the domains created here are listed in `factory::MadeDomains`
 std::unique_ptr<Environment> makeEnvironment(configurations::DomainConf const& c)
 {
 
@@ -1,14 +1,20 @@
 #include "BAPOMDPExperiment.hpp"
 
+#include <fstream>
+#include <memory>
+#include <unistd.h>
+
 #include "configurations/BAConf.hpp"
 
 #include "experiments/Episode.hpp"
+#include "experiments/Service.hpp"
 
 #include "bayes-adaptive/models/table/BAPOMDP.hpp"
 #include "bayes-adaptive/states/BAState.hpp"
 
 #include "beliefs/bayes-adaptive/BABelief.hpp"
 #include "environment/Environment.hpp"
+#include "planners/Telemetry.hpp"
 #include "planners/bayes-adaptive/BAPlanner.hpp"
 
 #include "environment/Horizon.hpp"
@@ -40,6 +46,23 @@ Result run(BAPOMDP const* bapomdp, configurations::BAConf const& conf)
     auto const discount = Discount(conf.discount);
     auto const h        = Horizon(conf.horizon);
 
+    // report planning statistics per step if requested
+    std::ofstream telemetry_file;
+    std::unique_ptr<planners::TelemetrySink> telemetry;
+    if (!conf.telemetry_file.empty())
+    {
+        telemetry_file.open(conf.telemetry_file);
+        if (!telemetry_file)
+        {
+            throw "failed to open telemetry file " + conf.telemetry_file;
+        }
+
+        telemetry.reset(new planners::TelemetrySink(
+            telemetry_file, planners::TelemetrySink::formatOf(conf.telemetry_file)));
+
+        planner->telemetry(telemetry.get());
+    }
+
     boost::timer timer;
     for (auto run = 0; run < conf.num_runs; ++run)
     {
@@ -59,7 +82,11 @@ Result run(BAPOMDP const* bapomdp, configurations::BAConf const& conf)
             belief->resetDomainStateDistribution(*bapomdp);
 
             timer.restart();
-            auto const r = episode::run(*planner, *belief, *env, *bapomdp, h, discount);
+            auto const r =
+                (conf.pipeline_particles > 0)
+                    ? episode::runPipelined(
+                        *planner, *belief, *env, *bapomdp, h, discount, conf.pipeline_particles)
+                    : episode::run(*planner, *belief, *env, *bapomdp, h, discount);
 
             learning_results.r[episode].ret.add(r.ret.toDouble());
             learning_results.r[episode].duration.add(timer.elapsed() / r.length);
@@ -74,7 +101,31 @@ Result run(BAPOMDP const* bapomdp, configurations::BAConf const& conf)
         belief->free(*bapomdp);
     }
 
+    planner->telemetry(nullptr);
+
     return learning_results;
 }
 
+void serve(BAPOMDP const* bapomdp, configurations::BAConf const& conf)
+{
+    auto const env = factory::makeEnvironment(conf.domain_conf);
+
+    Service service(
+        *env,
+        *bapomdp,
+        [&conf] { return factory::makeBAPlanner(conf); },
+        [&conf] { return factory::makeBABelief(conf); },
+        Horizon(conf.horizon),
+        Discount(conf.discount),
+        conf.service_workers);
+
+    if (conf.service == "-")
+    {
+        service.serve(STDIN_FILENO, STDOUT_FILENO);
+    } else
+    {
+        service.listen(conf.service);
+    }
+}
+
 }} // namespace experiment::bapomdp
@@ -39,6 +39,15 @@ struct Result : public el::Loggable
  **/
 Result run(BAPOMDP const* bapomdp, configurations::BAConf const& conf);
 
+/**
+ * @brief serves episode sessions of planners & learners until quit
+ *
+ * Every session starts learning from the prior
+ *
+ * @see `experiment::Service`
+ **/
+void serve(BAPOMDP const* bapomdp, configurations::BAConf const& conf);
+
 }} // namespace experiment::bapomdp
 
 #endif // BAPOMDPEXPERIMENT_HPP
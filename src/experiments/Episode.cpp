@@ -1,6 +1,11 @@
 #include "Episode.hpp"
 
+#include <atomic>
+#include <future>
+#include <memory>
+
 #include "beliefs/Belief.hpp"
+#include "beliefs/bayes-adaptive/BABelief.hpp"
 #include "domains/POMDP.hpp"
 #include "environment/Action.hpp"
 #include "environment/Environment.hpp"
@@ -11,8 +16,117 @@
 #include "environment/State.hpp"
 #include "environment/Terminal.hpp"
 #include "planners/Planner.hpp"
+#include "utils/random.hpp"
 
 namespace episode {
+
+namespace {
+
+// the number of attempts per speculative particle before giving up
+constexpr size_t const MAX_SPECULATION_ATTEMPTS = 10;
+
+/**
+ * @brief the belief to plan with while the actual belief is updated in the background
+ *
+ * Samples from a few speculatively updated particles until the update is
+ * done, and from the actual belief afterwards. Is a `BABelief`, such that
+ * bayes-adaptive planners can plan with it too.
+ **/
+class SpeculativeBelief : public beliefs::BABelief
+{
+public:
+    SpeculativeBelief(
+        Belief const& belief,
+        std::atomic<bool> const& updated,
+        std::shared_future<void> update,
+        std::vector<State const*> particles) :
+            _belief(belief),
+            _updated(updated),
+            _update(std::move(update)),
+            _particles(std::move(particles))
+    {
+    }
+
+    void initiate(POMDP const& /*domain*/) final
+    {
+        throw "SpeculativeBelief::initiate: cannot initiate a speculative belief";
+    }
+
+    /**
+     * @brief releases the speculative particles
+     **/
+    void free(POMDP const& domain) final
+    {
+        for (auto s : _particles) { domain.releaseState(s); }
+        _particles.clear();
+    }
+
+    State const* sample() const final
+    {
+        if (!_updated && !_particles.empty())
+        {
+            return _particles[rnd::slowRandomInt(0, _particles.size())];
+        }
+
+        _update.wait();
+        return _belief.sample();
+    }
+
+    void updateEstimation(Action const* /*a*/, Observation const* /*o*/, POMDP const& /*d*/) final
+    {
+        throw "SpeculativeBelief::updateEstimation: cannot update a speculative belief";
+    }
+
+    void resetDomainStateDistribution(BAPOMDP const& /*domain*/) final
+    {
+        throw "SpeculativeBelief::resetDomainStateDistribution: cannot reset a speculative belief";
+    }
+
+private:
+    Belief const& _belief;
+    std::atomic<bool> const& _updated;
+    std::shared_future<void> const _update;
+
+    std::vector<State const*> _particles;
+};
+
+/**
+ * @brief returns (up to) n particles updated with <a,o> through rejection sampling on `snapshot`
+ **/
+std::vector<State const*> speculate(
+    std::vector<State const*> const& snapshot,
+    Action const* a,
+    Observation const* o,
+    POMDP const& simulator,
+    size_t n)
+{
+    std::vector<State const*> particles;
+
+    Observation const* simulated_observation(nullptr);
+    Reward r(0);
+
+    for (size_t i = 0; i < MAX_SPECULATION_ATTEMPTS * n && particles.size() < n; ++i)
+    {
+        auto s = simulator.copyState(snapshot[i % snapshot.size()]);
+        simulator.step(&s, a, &simulated_observation, &r);
+
+        if (simulated_observation->index() == o->index())
+        {
+            particles.emplace_back(s);
+        } else
+        {
+            simulator.releaseState(s);
+        }
+
+        simulator.releaseObservation(simulated_observation);
+    }
+
+    VLOG(3) << "speculatively updated " << particles.size() << " particles";
+
+    return particles;
+}
+
+} // namespace
 Result
     run(Planner const& planner,
         Belief& belief,
@@ -63,4 +177,100 @@ Result
     return {ret, t};
 }
 
+Result runPipelined(
+    Planner const& planner,
+    Belief& belief,
+    Environment const& env,
+    POMDP const& simulator,
+    Horizon const& h,
+    Discount discount,
+    size_t num_particles)
+{
+    assert(h.toInt() > 0);
+    assert(discount.toDouble() >= 0 && discount.toDouble() <= 1);
+    assert(num_particles > 0);
+
+    auto r        = Reward(0);
+    auto ret      = Return();
+    auto terminal = Terminal(false);
+    Observation const* o;
+
+    State const* s = env.sampleStartState();
+    History hist;
+
+    // the belief update in the background (if any)
+    std::shared_future<void> update;
+    std::atomic<bool> updated(true);
+    std::vector<State const*> speculative_particles;
+
+    VLOG(2) << "Episode starts with s=" << s->toString();
+
+    // interact until horizon or terminal interaction occurred
+    auto t = 0;
+    for (t = 0; t < h.toInt() && !terminal.terminated(); ++t)
+    {
+        Action const* a;
+        if (update.valid())
+        {
+            SpeculativeBelief speculative_belief(
+                belief, updated, update, std::move(speculative_particles));
+
+            a = planner.selectAction(simulator, speculative_belief, hist);
+
+            speculative_belief.free(simulator);
+
+            // re-throws whatever went wrong during the update
+            update.get();
+            update = std::shared_future<void>();
+        } else
+        {
+            a = planner.selectAction(simulator, belief, hist);
+        }
+
+        terminal = env.step(&s, a, &o, &r);
+
+        VLOG(2) << "T=" << t << "\ta=" << a->toString() << "\ts'=" << s->toString()
+                << "\to=" << o->toString() << "\tr=" << r.toDouble();
+
+        // update in the background, while speculating on a snapshot of the belief
+        if (!terminal.terminated() && t + 1 < h.toInt())
+        {
+            std::vector<State const*> snapshot;
+            for (size_t i = 0; i < num_particles; ++i)
+            {
+                snapshot.emplace_back(simulator.copyState(belief.sample()));
+            }
+
+            auto const seed          = rnd::rng()();
+            auto const update_belief = [&belief, &simulator, &updated, a, o, seed] {
+                rnd::seedThread(seed);
+                belief.updateEstimation(a, o, simulator);
+                updated = true;
+            };
+
+            updated = false;
+            update  = std::async(std::launch::async, update_belief).share();
+
+            speculative_particles = speculate(snapshot, a, o, simulator, num_particles);
+
+            for (auto p : snapshot) { simulator.releaseState(p); }
+        } else if (!terminal.terminated())
+        {
+            belief.updateEstimation(a, o, simulator);
+        }
+
+        ret.add(r, discount);
+        discount.increment();
+
+        hist.add(a, o);
+    }
+
+    VLOG(2) << "End of episode at s=" << s->toString() << " with return=" << ret.toDouble();
+
+    hist.clear(simulator, env);
+    env.releaseState(s);
+
+    return {ret, t};
+}
+
 } // namespace episode
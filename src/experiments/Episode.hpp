@@ -2,6 +2,7 @@
 #define EPISODE_HPP
 
 #include <cassert>
+#include <cstddef>
 #include <vector>
 
 #include "easylogging++.h"
@@ -42,6 +43,27 @@ Result
         Horizon const& h,
         Discount discount);
 
+/**
+ * @brief runs an episode in which the belief updates overlap with planning
+ *
+ * Each belief update runs in the background while the planner already
+ * searches for the next action. Until the update is done, the planner
+ * samples from `num_particles` particles, updated (through rejection
+ * sampling) from a snapshot of the belief before the update. Afterwards, it
+ * samples from the updated belief.
+ *
+ * NOTE: assumes belief has got a legit estimation, and that the domain can
+ * be simulated from multiple threads
+ */
+Result runPipelined(
+    Planner const& planner,
+    Belief& belief,
+    Environment const& env,
+    POMDP const& simulator,
+    Horizon const& h,
+    Discount discount,
+    size_t num_particles);
+
 } // namespace episode
 
 #endif // EPISODE_HPP
@@ -1,14 +1,20 @@
 #include "PlanningExperiment.hpp"
 
+#include <fstream>
+#include <memory>
+#include <unistd.h>
+
 #include "configurations/Conf.hpp"
 
 #include "experiments/Episode.hpp"
+#include "experiments/Service.hpp"
 
 #include "domains/POMDP.hpp"
 #include "environment/Environment.hpp"
 
 #include "beliefs/Belief.hpp"
 #include "planners/Planner.hpp"
+#include "planners/Telemetry.hpp"
 
 #include "environment/Discount.hpp"
 #include "environment/Horizon.hpp"
@@ -28,13 +34,31 @@ Result run(configurations::Conf const& conf)
 {
     auto planning_result = Result();
 
+    // the simulator outlives the planner, which may keep a tree with its actions
     auto const env       = factory::makeEnvironment(conf.domain_conf);
-    auto const planner   = factory::makePlanner(conf);
     auto const simulator = factory::makePOMDP(conf.domain_conf);
+    auto const planner   = factory::makePlanner(conf);
     auto const belief    = factory::makeBelief(conf);
     auto const discount  = Discount(conf.discount);
     auto const h         = Horizon(conf.horizon);
 
+    // report planning statistics per step if requested
+    std::ofstream telemetry_file;
+    std::unique_ptr<planners::TelemetrySink> telemetry;
+    if (!conf.telemetry_file.empty())
+    {
+        telemetry_file.open(conf.telemetry_file);
+        if (!telemetry_file)
+        {
+            throw "failed to open telemetry file " + conf.telemetry_file;
+        }
+
+        telemetry.reset(new planners::TelemetrySink(
+            telemetry_file, planners::TelemetrySink::formatOf(conf.telemetry_file)));
+
+        planner->telemetry(telemetry.get());
+    }
+
     boost::timer timer;
     for (auto run = 0; run < conf.num_runs; ++run)
     {
@@ -43,7 +67,11 @@ Result run(configurations::Conf const& conf)
         belief->initiate(*simulator);
 
         timer.restart();
-        auto const r = episode::run(*planner, *belief, *env, *simulator, h, discount);
+        auto const r =
+            (conf.pipeline_particles > 0)
+                ? episode::runPipelined(
+                    *planner, *belief, *env, *simulator, h, discount, conf.pipeline_particles)
+                : episode::run(*planner, *belief, *env, *simulator, h, discount);
 
         planning_result.episode_return.add(r.ret.toDouble());
         planning_result.episode_duration.add(timer.elapsed() / r.length);
@@ -51,7 +79,32 @@ Result run(configurations::Conf const& conf)
         belief->free(*simulator);
     }
 
+    planner->telemetry(nullptr);
+
     return planning_result;
 }
 
+void serve(configurations::Conf const& conf)
+{
+    auto const env       = factory::makeEnvironment(conf.domain_conf);
+    auto const simulator = factory::makePOMDP(conf.domain_conf);
+
+    Service service(
+        *env,
+        *simulator,
+        [&conf] { return factory::makePlanner(conf); },
+        [&conf] { return factory::makeBelief(conf); },
+        Horizon(conf.horizon),
+        Discount(conf.discount),
+        conf.service_workers);
+
+    if (conf.service == "-")
+    {
+        service.serve(STDIN_FILENO, STDOUT_FILENO);
+    } else
+    {
+        service.listen(conf.service);
+    }
+}
+
 }} // namespace experiment::planning
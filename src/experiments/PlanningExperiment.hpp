@@ -29,6 +29,13 @@ struct Result : public el::Loggable
  **/
 Result run(configurations::Conf const& conf);
 
+/**
+ * @brief serves episode sessions of planners (no learning) until quit
+ *
+ * @see `experiment::Service`
+ **/
+void serve(configurations::Conf const& conf);
+
 }} // namespace experiment::planning
 
 #endif // PLANNINGEXPERIMENT_HPP
@@ -0,0 +1,537 @@
+#include "Service.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <exception>
+#include <sstream>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "easylogging++.h"
+
+#include "beliefs/Belief.hpp"
+#include "domains/POMDP.hpp"
+#include "environment/Action.hpp"
+#include "environment/Environment.hpp"
+#include "environment/Observation.hpp"
+#include "environment/Reward.hpp"
+#include "environment/State.hpp"
+#include "environment/Terminal.hpp"
+#include "planners/Planner.hpp"
+#include "utils/random.hpp"
+
+namespace experiment {
+
+/**
+ * @brief a client: reads requests (lines) from one file descriptor and writes replies to another
+ *
+ * Replies can be written by any thread
+ **/
+class Service::Connection
+{
+public:
+    /**
+     * @brief closes the file descriptors on destruction if `owned` (sockets)
+     **/
+    Connection(int in, int out, bool owned) : _in(in), _out(out), _owned(owned) {}
+
+    ~Connection()
+    {
+        if (_owned)
+        {
+            ::close(_in);
+            if (_out != _in)
+            {
+                ::close(_out);
+            }
+        }
+    }
+
+    Connection(Connection const&) = delete;
+    Connection& operator=(Connection const&) = delete;
+
+    /**
+     * @brief reads the next line into `line`, returns false at the end of input
+     **/
+    bool readLine(std::string* line)
+    {
+        char chunk[4096];
+
+        auto end = _buffer.find('\n');
+        while (end == std::string::npos)
+        {
+            auto const n = ::read(_in, chunk, sizeof(chunk));
+
+            if (n < 0 && errno == EINTR)
+            {
+                continue;
+            }
+
+            if (n <= 0)
+            {
+                // the last line may not be terminated
+                line->swap(_buffer);
+                _buffer.clear();
+                return !line->empty();
+            }
+
+            _buffer.append(chunk, n);
+            end = _buffer.find('\n');
+        }
+
+        line->assign(_buffer, 0, end);
+        _buffer.erase(0, end + 1);
+
+        return true;
+    }
+
+    void write(std::string const& reply)
+    {
+        auto const line = reply + "\n";
+
+        std::lock_guard<std::mutex> l(_write_mutex);
+
+        size_t written = 0;
+        while (written < line.size())
+        {
+            auto const n = ::write(_out, line.data() + written, line.size() - written);
+
+            if (n < 0 && errno == EINTR)
+            {
+                continue;
+            }
+
+            if (n <= 0)
+            {
+                VLOG(1) << "service failed to reply (" << std::strerror(errno) << "): " << reply;
+                return;
+            }
+
+            written += n;
+        }
+    }
+
+    /**
+     * @brief makes a blocking `readLine` return (only affects sockets)
+     **/
+    void stopReading() { ::shutdown(_in, SHUT_RD); }
+
+private:
+    int const _in, _out;
+    bool const _owned;
+
+    std::string _buffer     = "";
+    std::mutex _write_mutex = {};
+};
+
+Service::Service(
+    Environment const& env,
+    POMDP const& simulator,
+    PlannerFactory const& make_planner,
+    BeliefFactory make_belief,
+    Horizon const& h,
+    Discount discount,
+    int num_workers) :
+        _env(env),
+        _simulator(simulator),
+        _make_belief(std::move(make_belief)),
+        _h(h),
+        _discount(discount)
+{
+    if (num_workers < 1)
+    {
+        throw "cannot start service with " + std::to_string(num_workers)
+            + " workers, must be greater than 0";
+    }
+
+    for (auto i = 0; i < num_workers; ++i) { _planners.emplace_back(make_planner()); }
+
+    // worker i draws from stream i of a seed drawn here, such that the main seed seeds the workers
+    auto const seed = rnd::rng()();
+    for (auto i = 0u; i < _planners.size(); ++i)
+    {
+        auto const& p = _planners[i];
+        _workers.emplace_back([this, &p, seed, i] { work(*p, seed, i); });
+    }
+
+    VLOG(1) << "started service with " << num_workers << " worker(s)";
+}
+
+Service::~Service()
+{
+    {
+        std::lock_guard<std::mutex> l(_mutex);
+        _stopping = true;
+    }
+
+    _work.notify_all();
+    for (auto& w : _workers) { w.join(); }
+
+    // sessions that were never closed
+    for (auto& s : _sessions) { free(s.second.get()); }
+
+    VLOG(1) << "stopped service after " << _next_id << " session(s)";
+}
+
+void Service::serve(int in, int out)
+{
+    read(std::make_shared<Connection>(in, out, false));
+    waitUntilServed();
+}
+
+void Service::listen(std::string const& path)
+{
+    sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+
+    if (path.size() >= sizeof(address.sun_path))
+    {
+        throw "socket path " + path + " is too long";
+    }
+
+    std::strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+
+    auto const listener = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listener < 0)
+    {
+        throw "failed to create socket " + path + ": " + std::strerror(errno);
+    }
+
+    ::unlink(path.c_str());
+    if (::bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0
+        || ::listen(listener, SOMAXCONN) != 0)
+    {
+        auto const e = std::string(std::strerror(errno));
+        ::close(listener);
+        throw "failed to listen on " + path + ": " + e;
+    }
+
+    // clients that disconnect should not kill the service
+    std::signal(SIGPIPE, SIG_IGN);
+
+    _listener = listener;
+    VLOG(1) << "service listening on " << path;
+
+    // the reader of each connection, joined once the connection is expired
+    std::vector<std::pair<std::weak_ptr<Connection>, std::thread>> readers;
+    while (!_quit)
+    {
+        auto const fd = ::accept(listener, nullptr, nullptr);
+        if (fd < 0)
+        {
+            if (errno == EINTR || errno == ECONNABORTED)
+            {
+                continue;
+            }
+
+            break; // `quit` shuts the listener down
+        }
+
+        auto const c = std::make_shared<Connection>(fd, fd, true);
+
+        {
+            std::lock_guard<std::mutex> l(_mutex);
+
+            _connections.erase(
+                std::remove_if(
+                    _connections.begin(),
+                    _connections.end(),
+                    [](std::weak_ptr<Connection> const& connection) {
+                        return connection.expired();
+                    }),
+                _connections.end());
+            _connections.emplace_back(c);
+        }
+
+        // a connection expires after its reader is done and its requests are replied to
+        auto const done = std::partition(
+            readers.begin(),
+            readers.end(),
+            [](std::pair<std::weak_ptr<Connection>, std::thread> const& r) {
+                return !r.first.expired();
+            });
+        for (auto r = done; r != readers.end(); ++r) { r->second.join(); }
+        readers.erase(done, readers.end());
+
+        readers.emplace_back(c, std::thread([this, c] { read(c); }));
+    }
+
+    for (auto& r : readers) { r.second.join(); }
+
+    ::close(listener);
+    ::unlink(path.c_str());
+
+    waitUntilServed();
+}
+
+void Service::read(std::shared_ptr<Connection> const& c)
+{
+    std::string line;
+    while (!_quit && c->readLine(&line))
+    {
+        if (line == "quit")
+        {
+            quit();
+            break;
+        }
+
+        receive(line, c);
+    }
+}
+
+void Service::quit()
+{
+    _quit = true;
+
+    auto const listener = _listener.exchange(-1);
+    if (listener >= 0)
+    {
+        ::shutdown(listener, SHUT_RDWR);
+    }
+
+    std::lock_guard<std::mutex> l(_mutex);
+    for (auto const& c : _connections)
+    {
+        if (auto const connection = c.lock())
+        {
+            connection->stopReading();
+        }
+    }
+}
+
+void Service::receive(std::string const& line, std::shared_ptr<Connection> const& c)
+{
+    std::istringstream tokens(line);
+
+    std::string command;
+    tokens >> command;
+
+    if (command.empty())
+    {
+        return;
+    }
+
+    if (command == "open")
+    {
+        std::lock_guard<std::mutex> l(_mutex);
+
+        auto const id = _next_id++;
+        auto const s  = new Session(id, _discount);
+
+        _sessions.emplace(id, std::unique_ptr<Session>(s));
+        schedule(s, {OPEN, c});
+
+        return;
+    }
+
+    if (command != "step" && command != "close")
+    {
+        c->write("error unknown request: " + line);
+        return;
+    }
+
+    int id = -1;
+    if (!(tokens >> id))
+    {
+        c->write("error missing session id: " + line);
+        return;
+    }
+
+    std::unique_lock<std::mutex> l(_mutex);
+
+    auto const s = _sessions.find(id);
+    if (s == _sessions.end() || s->second->closing)
+    {
+        l.unlock();
+        c->write("error unknown session " + std::to_string(id));
+        return;
+    }
+
+    if (command == "close")
+    {
+        s->second->closing = true;
+    }
+
+    schedule(s->second.get(), {(command == "step") ? STEP : CLOSE, c});
+}
+
+void Service::schedule(Session* s, Request r)
+{
+    s->pending.emplace_back(std::move(r));
+    ++_num_unserved;
+
+    if (!s->scheduled)
+    {
+        s->scheduled = true;
+        _ready.emplace_back(s);
+        _work.notify_one();
+    }
+}
+
+void Service::work(Planner const& planner, unsigned int seed, unsigned int stream)
+{
+    rnd::seedStream(seed, stream);
+
+    std::unique_lock<std::mutex> l(_mutex);
+    while (true)
+    {
+        _work.wait(l, [this] { return _stopping || !_ready.empty(); });
+
+        if (_ready.empty())
+        {
+            return;
+        }
+
+        auto const s = _ready.front();
+        _ready.pop_front();
+
+        auto const r = s->pending.front();
+        s->pending.pop_front();
+
+        // the session is not accessed by any other worker until it is scheduled again
+        l.unlock();
+
+        std::string reply;
+        try
+        {
+            reply = execute(s, r.command, planner);
+        } catch (char const* e)
+        {
+            reply = std::to_string(s->id) + " error " + e;
+        } catch (std::string const& e)
+        {
+            reply = std::to_string(s->id) + " error " + e;
+        } catch (std::exception const& e)
+        {
+            reply = std::to_string(s->id) + " error " + e.what();
+        } catch (...)
+        {
+            reply = std::to_string(s->id) + " error unknown failure";
+        }
+
+        r.connection->write(reply);
+
+        l.lock();
+
+        if (r.command == CLOSE)
+        {
+            _sessions.erase(s->id);
+        } else if (!s->pending.empty())
+        {
+            _ready.emplace_back(s);
+            _work.notify_one();
+        } else
+        {
+            s->scheduled = false;
+        }
+
+        --_num_unserved;
+        _idle.notify_all();
+    }
+}
+
+std::string Service::execute(Session* s, Command command, Planner const& planner)
+{
+    auto const id = std::to_string(s->id);
+
+    if (command == OPEN)
+    {
+        s->belief = _make_belief();
+        s->belief->initiate(_simulator);
+        s->state = _env.sampleStartState();
+
+        VLOG(2) << "service opened session " << id << " in s=" << s->state->toString();
+
+        return id + " opened";
+    }
+
+    if (command == CLOSE)
+    {
+        std::ostringstream reply;
+        reply << id << " closed " << s->ret.toDouble() << " " << s->length;
+
+        free(s);
+
+        VLOG(2) << "service " << reply.str();
+
+        return reply.str();
+    }
+
+    // step, as in `episode::run`
+    if (s->belief == nullptr)
+    {
+        throw std::string("session failed to open");
+    }
+
+    if (s->terminal || s->length >= _h.toInt())
+    {
+        throw std::string("episode has ended");
+    }
+
+    Observation const* o(nullptr);
+    Reward r(0);
+
+    auto const a = planner.selectAction(_simulator, *s->belief, s->history);
+
+    // a and o are owned by the history only once added to it
+    try
+    {
+        s->terminal = _env.step(&s->state, a, &o, &r).terminated();
+
+        if (!s->terminal)
+        {
+            s->belief->updateEstimation(a, o, _simulator);
+        }
+    } catch (...)
+    {
+        _simulator.releaseAction(a);
+        if (o != nullptr)
+        {
+            _env.releaseObservation(o);
+        }
+
+        throw;
+    }
+
+    s->ret.add(r, s->discount);
+    s->discount.increment();
+    s->length++;
+
+    s->history.add(a, o);
+
+    std::ostringstream reply;
+    reply << id << " " << a->index() << " " << o->index() << " " << r.toDouble() << " "
+          << s->terminal;
+
+    return reply.str();
+}
+
+void Service::free(Session* s)
+{
+    s->history.clear(_simulator, _env);
+
+    if (s->state != nullptr)
+    {
+        _env.releaseState(s->state);
+        s->state = nullptr;
+    }
+
+    if (s->belief != nullptr)
+    {
+        s->belief->free(_simulator);
+        s->belief.reset();
+    }
+}
+
+void Service::waitUntilServed()
+{
+    std::unique_lock<std::mutex> l(_mutex);
+    _idle.wait(l, [this] { return _num_unserved == 0; });
+}
+
+} // namespace experiment
@@ -0,0 +1,181 @@
+#ifndef SERVICE_HPP
+#define SERVICE_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "environment/Discount.hpp"
+#include "environment/History.hpp"
+#include "environment/Horizon.hpp"
+#include "environment/Return.hpp"
+
+class Belief;
+class Environment;
+class POMDP;
+class Planner;
+class State;
+
+namespace experiment {
+
+/**
+ * @brief A long-running process that plans for many episodes (sessions) at once
+ *
+ * The domain and planners are created once, after which any number of
+ * independent episodes can be run through requests. Each session owns its
+ * own belief, history and (environment) state. Requests are executed by a
+ * pool of workers, each with its own planner, such that many sessions are
+ * planned for concurrently. The requests of a single session are executed
+ * in order.
+ *
+ * Requests and replies are lines of text:
+ *
+ * - `open` -> `<id> opened`: starts a new episode
+ * - `step <id>` -> `<id> <action> <observation> <reward> <terminal>`: plans,
+ *   executes the action in the environment and updates the belief (indices
+ *   of the action & observation, terminal is 0 or 1)
+ * - `close <id>` -> `<id> closed <return> <length>`: ends the session
+ * - `quit`: stops reading requests (those already received are still served)
+ *
+ * Failures are replied as `error <message>` or `<id> error <message>`.
+ **/
+class Service
+{
+public:
+    using PlannerFactory = std::function<std::unique_ptr<Planner>()>;
+    using BeliefFactory  = std::function<std::unique_ptr<Belief>()>;
+
+    /**
+     * @brief starts `num_workers` workers, each with a planner from `make_planner`
+     *
+     * `env` and `simulator` must outlive the service, and are shared by all
+     * workers without locking: only their const interface is used, which
+     * the domains implement without (mutable) state of their own, drawing
+     * from the random generator of the calling thread instead.
+     **/
+    Service(
+        Environment const& env,
+        POMDP const& simulator,
+        PlannerFactory const& make_planner,
+        BeliefFactory make_belief,
+        Horizon const& h,
+        Discount discount,
+        int num_workers);
+
+    /**
+     * @brief serves all received requests, then stops the workers and frees open sessions
+     **/
+    ~Service();
+
+    Service(Service const&) = delete;
+    Service& operator=(Service const&) = delete;
+
+    /**
+     * @brief serves the requests read from file descriptor `in`, replies are written to `out`
+     *
+     * Returns at the end of input or after `quit`, once all replies are written
+     **/
+    void serve(int in, int out);
+
+    /**
+     * @brief serves the connections to a Unix socket at `path` until some client sends `quit`
+     **/
+    void listen(std::string const& path);
+
+private:
+    class Connection;
+
+    enum Command { OPEN, STEP, CLOSE };
+
+    struct Request
+    {
+        Command command;
+        std::shared_ptr<Connection> connection;
+    };
+
+    /**
+     * @brief an episode: only accessed by the (single) worker that executes its request
+     **/
+    struct Session
+    {
+        int const id;
+
+        std::deque<Request> pending = {};
+        bool scheduled              = false; // whether in the queue or being served
+        bool closing                = false; // whether `close` has been requested
+
+        std::unique_ptr<Belief> belief = nullptr;
+        State const* state             = nullptr;
+        History history                = History();
+        Return ret                     = Return();
+        Discount discount;
+        int length    = 0;
+        bool terminal = false;
+
+        Session(int i, Discount d) : id(i), discount(d) {}
+
+        Session(Session const&) = delete;
+        Session& operator=(Session const&) = delete;
+    };
+
+    // shared by the workers, see the constructor
+    Environment const& _env;
+    POMDP const& _simulator;
+    BeliefFactory const _make_belief;
+    Horizon const _h;
+    Discount const _discount;
+
+    std::vector<std::unique_ptr<Planner>> _planners = {};
+    std::vector<std::thread> _workers               = {};
+
+    // guards the sessions and queue
+    std::mutex _mutex = {};
+
+    std::condition_variable _work = {}; // signalled when sessions are ready or when stopping
+    std::condition_variable _idle = {}; // signalled when a request is served
+
+    std::map<int, std::unique_ptr<Session>> _sessions   = {};
+    std::deque<Session*> _ready                         = {};
+    std::vector<std::weak_ptr<Connection>> _connections = {}; // of the socket
+
+    int _next_id      = 0;
+    int _num_unserved = 0; // requests received but not yet served
+    bool _stopping    = false;
+
+    // set by `quit`, read by the connections
+    std::atomic<bool> _quit{false};
+    std::atomic<int> _listener{-1};
+
+    /**
+     * @brief reads requests from the connection and queues them until `quit` or end of input
+     **/
+    void read(std::shared_ptr<Connection> const& c);
+
+    /**
+     * @brief stops reading requests from all connections
+     **/
+    void quit();
+
+    /**
+     * @brief queues the request (line) or replies an error if it is not valid
+     **/
+    void receive(std::string const& line, std::shared_ptr<Connection> const& c);
+    void schedule(Session* s, Request r);
+
+    void work(Planner const& planner, unsigned int seed, unsigned int stream);
+    std::string execute(Session* s, Command command, Planner const& planner);
+    void free(Session* s);
+
+    void waitUntilServed();
+};
+
+} // namespace experiment
+
+#endif // SERVICE_HPP
@@ -35,10 +35,20 @@ int main(int argc, char* argv[])
     /***** run program *****/
     try
     {
+        auto const fbapomdp = factory::makeFBAPOMDP(conf);
+
+        if (!conf.service.empty())
+        {
+            LOG(INFO) << "(" << conf.id << "): Starting FBAPOMDP service";
+            experiment::bapomdp::serve(fbapomdp.get(), conf);
+            LOG(INFO) << "(" << conf.id << "): Stopped FBAPOMDP service";
+
+            return 0;
+        }
+
         LOG(INFO) << "(" << conf.id << "): Starting FBAPOMDP experiment";
 
-        auto const fbapomdp = factory::makeFBAPOMDP(conf);
-        auto const res      = experiment::bapomdp::run(fbapomdp.get(), conf);
+        auto const res = experiment::bapomdp::run(fbapomdp.get(), conf);
 
         std::ofstream f(conf.output_file);
         f << res << std::endl;
@@ -5,6 +5,8 @@
 #include "planners/random/RandomPlanner.hpp"
 #include "planners/ts/TSPlanner.hpp"
 
+void Planner::telemetry(planners::TelemetrySink* /*sink*/) {}
+
 namespace factory {
 
 std::unique_ptr<Planner> makePlanner(configurations::Conf const& c)
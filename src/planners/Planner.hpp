@@ -10,6 +10,9 @@ class POMDP;
 namespace configurations {
 struct Conf;
 }
+namespace planners {
+class TelemetrySink;
+}
 
 /**
  * @brief The interface of a planner: it requires to select an action based on a belief and/or
@@ -22,6 +25,14 @@ public:
 
     virtual Action const*
         selectAction(POMDP const& simulator, Belief const& belief, History const& h) const = 0;
+
+    /**
+     * @brief makes the planner write statistics of each `selectAction` call to `sink`
+     *
+     * Ignored by planners that have no statistics to report (the default).
+     * Pass nullptr to stop reporting.
+     **/
+    virtual void telemetry(planners::TelemetrySink* sink);
 };
 
 namespace factory {
@@ -0,0 +1,57 @@
+#include "Telemetry.hpp"
+
+namespace planners {
+
+double Telemetry::simulationsPerSecond() const
+{
+    return (seconds > 0) ? simulations / seconds : 0;
+}
+
+TelemetrySink::TelemetrySink(std::ostream& os, Format format) : _os(os), _format(format) {}
+
+TelemetrySink::Format TelemetrySink::formatOf(std::string const& path)
+{
+    auto const endsWith = [&path](std::string const& suffix) {
+        return path.size() >= suffix.size()
+               && path.compare(path.size() - suffix.size(), suffix.size(), suffix) == 0;
+    };
+
+    return (endsWith(".jsonl") || endsWith(".json")) ? JSONL : CSV;
+}
+
+void TelemetrySink::write(Telemetry const& t)
+{
+    if (_format == CSV)
+    {
+        if (!_wrote_header)
+        {
+            _os << "planner,simulations,seconds,simulations_per_second,nodes,peak_tree_bytes,"
+                   "max_depth,rollout_steps,selection_seconds,simulation_seconds,"
+                   "rollout_seconds,simulations_saved,simulations_reused,transpositions\n";
+            _wrote_header = true;
+        }
+
+        _os << t.planner << "," << t.simulations << "," << t.seconds << ","
+            << t.simulationsPerSecond() << "," << t.nodes << "," << t.peak_tree_bytes << ","
+            << t.max_depth << "," << t.rollout_steps << "," << t.selection_seconds << ","
+            << t.simulation_seconds << "," << t.rollout_seconds << "," << t.simulations_saved
+            << "," << t.simulations_reused << "," << t.transpositions << "\n";
+    } else
+    {
+        _os << "{\"planner\": \"" << t.planner << "\", \"simulations\": " << t.simulations
+            << ", \"seconds\": " << t.seconds
+            << ", \"simulations_per_second\": " << t.simulationsPerSecond()
+            << ", \"nodes\": " << t.nodes << ", \"peak_tree_bytes\": " << t.peak_tree_bytes
+            << ", \"max_depth\": " << t.max_depth << ", \"rollout_steps\": " << t.rollout_steps
+            << ", \"selection_seconds\": " << t.selection_seconds
+            << ", \"simulation_seconds\": " << t.simulation_seconds
+            << ", \"rollout_seconds\": " << t.rollout_seconds
+            << ", \"simulations_saved\": " << t.simulations_saved
+            << ", \"simulations_reused\": " << t.simulations_reused
+            << ", \"transpositions\": " << t.transpositions << "}\n";
+    }
+
+    _os.flush();
+}
+
+} // namespace planners
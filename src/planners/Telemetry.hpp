@@ -0,0 +1,68 @@
+#ifndef TELEMETRY_HPP
+#define TELEMETRY_HPP
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+
+namespace planners {
+
+/**
+ * @brief The statistics of a single planning call (step)
+ *
+ * The time spent is split in simulating steps within the tree, rolling out
+ * and selection (everything else: picking actions, growing the tree and
+ * backing up returns). When searching with multiple threads, these are
+ * summed over the threads, while `seconds` is the wall-clock time of the call.
+ **/
+struct Telemetry
+{
+    std::string planner = "";
+
+    int simulations        = 0;
+    double seconds         = 0;
+    int nodes              = 0;
+    size_t peak_tree_bytes = 0;
+    int max_depth          = 0;
+    long rollout_steps     = 0;
+    int simulations_saved  = 0; // by stopping early
+    int simulations_reused = 0; // root visits carried over from the previous tree
+    int transpositions     = 0; // nodes shared through the transposition table
+
+    double selection_seconds  = 0;
+    double simulation_seconds = 0;
+    double rollout_seconds    = 0;
+
+    double simulationsPerSecond() const;
+};
+
+/**
+ * @brief writes `Telemetry` records, one per line, as CSV or JSON
+ *
+ * The stream is owned by the caller and must outlive the sink. A CSV sink
+ * writes a header before its first record.
+ **/
+class TelemetrySink
+{
+public:
+    enum Format { CSV, JSONL };
+
+    TelemetrySink(std::ostream& os, Format format);
+
+    /**
+     * @brief returns the format to use for file `path`: JSONL for .jsonl or .json, CSV otherwise
+     **/
+    static Format formatOf(std::string const& path);
+
+    void write(Telemetry const& t);
+
+private:
+    std::ostream& _os;
+    Format const _format;
+
+    bool _wrote_header = false;
+};
+
+} // namespace planners
+
+#endif // TELEMETRY_HPP
@@ -0,0 +1,422 @@
+#include "MCTS.hpp"
+
+#include <cstddef>
+#include <fstream>
+#include <iterator>
+#include <utility>
+
+#include "configurations/Conf.hpp"
+#include "domains/POMDP.hpp"
+
+namespace planners {
+
+MCTS::MCTS(configurations::Conf const& c, std::string name) :
+        _name(std::move(name)),
+        _n(c.planner_conf.mcts_simulation_amount),
+        _max_depth(c.planner_conf.mcts_max_depth),
+        _h(c.horizon),
+        _u(c.planner_conf.mcts_exploration_const),
+        _discount(c.discount),
+        _num_threads(c.planner_conf.mcts_threads),
+        _tree_parallel(_num_threads > 1 && c.planner_conf.mcts_parallelization == "tree"),
+        _reuse_tree(c.planner_conf.mcts_reuse_tree),
+        _time_budget(c.planner_conf.mcts_time_ms),
+        _pw_k(c.planner_conf.mcts_pw_k),
+        _pw_alpha(c.planner_conf.mcts_pw_alpha),
+        _rollout_policy(rolloutPolicy(c.planner_conf.mcts_rollout, _name)),
+        _rollout_depth(c.planner_conf.mcts_rollout_depth),
+        _transposition_size(std::max(c.planner_conf.mcts_transposition_size, 0)),
+        _transposition_steps(c.planner_conf.mcts_transposition_steps),
+        _max_nodes(perContext(c.planner_conf.mcts_max_nodes, _num_threads)),
+        _max_bytes(perContext(c.planner_conf.mcts_max_bytes, _num_threads)),
+        _early_stop_interval(c.planner_conf.mcts_early_stop_interval),
+        _simulation_streams(c.planner_conf.mcts_simulation_streams),
+        _value_table(
+            _rollout_policy == VALUE_TABLE ? readValueTable(c.planner_conf.mcts_value_table, _name)
+                                           : std::vector<double>()),
+        _log_table(std::max(_n, 0)),
+        _contexts(std::max(_num_threads, 1))
+{
+
+    if (_n < 1)
+    {
+        throw "cannot initiate " + _name + " with " + std::to_string(_n)
+            + " simulations, must be greater than 0";
+    }
+
+    if (_max_depth < 0)
+    {
+        throw "cannot initiate " + _name + " with " + std::to_string(_max_depth)
+            + " max depth, must be greater or equal to 0";
+    }
+
+    if (_h <= 0)
+    {
+        throw "cannot initiate " + _name + " with " + std::to_string(_h)
+            + " horizon, must be greater than 0";
+    }
+
+    if (_num_threads < 1)
+    {
+        throw "cannot initiate " + _name + " with " + std::to_string(_num_threads)
+            + " threads, must be greater than 0";
+    }
+
+    if (_time_budget.count() < 0)
+    {
+        throw "cannot initiate " + _name + " with " + std::to_string(_time_budget.count())
+            + " ms per call, must be greater or equal to 0";
+    }
+
+    if (c.planner_conf.mcts_parallelization != "root"
+        && c.planner_conf.mcts_parallelization != "tree")
+    {
+        throw "cannot initiate " + _name + " with " + c.planner_conf.mcts_parallelization
+            + " parallelization, must be 'root' or 'tree'";
+    }
+
+    if (_pw_k < 0 || _pw_alpha < 0 || _pw_alpha > 1)
+    {
+        throw "cannot initiate " + _name + " with progressive widening k=" + std::to_string(_pw_k)
+            + " and alpha=" + std::to_string(_pw_alpha)
+            + ", k must be positive (or 0) and alpha between 0 and 1";
+    }
+
+    if (_rollout_depth < 0)
+    {
+        throw "cannot initiate " + _name + " with " + std::to_string(_rollout_depth)
+            + " rollout depth, must be greater or equal to 0";
+    }
+
+    if (c.planner_conf.mcts_transposition_size < 0 || _transposition_steps < 1)
+    {
+        throw "cannot initiate " + _name + " with a transposition table of "
+            + std::to_string(c.planner_conf.mcts_transposition_size) + " entries and "
+            + std::to_string(_transposition_steps)
+            + " steps, must be greater or equal to 0 and greater than 0 respectively";
+    }
+
+    if (c.planner_conf.mcts_max_nodes < 0 || c.planner_conf.mcts_max_bytes < 0)
+    {
+        throw "cannot initiate " + _name + " with a maximum of "
+            + std::to_string(c.planner_conf.mcts_max_nodes) + " nodes and "
+            + std::to_string(c.planner_conf.mcts_max_bytes)
+            + " bytes, must be greater or equal to 0";
+    }
+
+    if (_early_stop_interval < 0)
+    {
+        throw "cannot initiate " + _name + " with an early stop interval of "
+            + std::to_string(_early_stop_interval) + ", must be greater or equal to 0";
+    }
+
+    for (auto& context : _contexts)
+    {
+        context.transpositions = TranspositionTable(_transposition_size);
+    }
+    _spare_context.transpositions = TranspositionTable(_transposition_size);
+
+    // make sure we are working with actual discount
+    const_cast<Discount*>(&_discount)->increment();
+
+    initiateLogTable();
+
+    VLOG(1) << "initiated " << _name << " planner with "
+            << (_time_budget.count() > 0 ? std::to_string(_time_budget.count()) + " ms"
+                                         : std::to_string(_n) + " simulations")
+            << ", " << _max_depth << " max depth, " << _u << " exploration constant, "
+            << _discount.toDouble() << " discount, " << _h << " horizon and " << _num_threads
+            << " thread(s) (" << c.planner_conf.mcts_parallelization << " parallelization)"
+            << (_reuse_tree ? ", reusing the tree" : "") << ", "
+            << c.planner_conf.mcts_rollout << " rollouts"
+            << (_transposition_size > 0
+                    ? ", a transposition table of " + std::to_string(_transposition_size)
+                          + " entries"
+                    : "")
+            << (_pw_k > 0 ? ", observation progressive widening (k=" + std::to_string(_pw_k)
+                                + ", alpha=" + std::to_string(_pw_alpha) + ")"
+                          : "")
+            << (_max_nodes > 0 ? ", at most " + std::to_string(_max_nodes) + " nodes" : "")
+            << (_max_bytes > 0 ? ", at most " + std::to_string(_max_bytes) + " bytes" : "")
+            << (_max_nodes > 0 || _max_bytes > 0 ? " per thread" : "")
+            << (_early_stop_interval > 0
+                    ? ", stopping early (checked every " + std::to_string(_early_stop_interval)
+                          + " simulations)"
+                    : "")
+            << (_simulation_streams ? ", a random stream per simulation" : "");
+}
+
+MCTS::~MCTS()
+{
+    // the tree kept for re-use still holds the actions interned from its domain
+    if (_previous_root != nullptr)
+    {
+        freeTree(*_previous_domain);
+        return;
+    }
+
+    for (auto& c : _contexts)
+    {
+        for (auto& n : c.action_nodes) { n->~ActionNode(); }
+    }
+}
+
+void MCTS::telemetry(TelemetrySink* sink)
+{
+    _telemetry = sink;
+}
+
+void MCTS::reportTelemetry(std::chrono::steady_clock::time_point start) const
+{
+    using seconds = std::chrono::duration<double>;
+
+    auto const& stats = _contexts[0].stats;
+
+    Telemetry t;
+
+    t.planner            = _name;
+    t.simulations        = stats.num_simulations;
+    t.seconds            = seconds(std::chrono::steady_clock::now() - start).count();
+    t.max_depth          = stats.tree_depth;
+    t.rollout_steps      = stats.num_rollout_steps;
+    t.simulations_saved  = stats.num_saved;
+    t.simulations_reused = stats.num_reused;
+    t.transpositions     = stats.num_transpositions;
+    t.nodes              = 0;
+    t.peak_tree_bytes    = 0;
+
+    // the tree only grows during a call, so its current size is its peak
+    for (auto const& c : _contexts)
+    {
+        t.nodes += c.stats.num_action_nodes;
+        t.peak_tree_bytes += c.node_arena.bytesAllocated() + c.heap_bytes;
+    }
+
+    t.simulation_seconds = seconds(stats.step_time).count();
+    t.rollout_seconds    = seconds(stats.rollout_time).count();
+    t.selection_seconds =
+        seconds(stats.search_time - stats.step_time - stats.rollout_time).count();
+
+    _telemetry->write(t);
+}
+
+int MCTS::simulationBudget() const
+{
+    return (_time_budget.count() > 0) ? std::numeric_limits<int>::max() : _n;
+}
+
+bool MCTS::outOfTime() const
+{
+    return _time_budget.count() > 0 && std::chrono::steady_clock::now() >= _deadline;
+}
+
+bool MCTS::settled(ActionNode* root, long remaining) const
+{
+    auto most_visited = 0;
+    for (auto a = 1; a < root->numChildren(); ++a)
+    {
+        if (root->visited(a) > root->visited(most_visited))
+        {
+            most_visited = a;
+        }
+    }
+
+    // (ties are never settled, as the other action could still get more visits)
+    for (auto a = 0; a < root->numChildren(); ++a)
+    {
+        if (a != most_visited && root->visited(a) + remaining >= root->visited(most_visited))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool MCTS::followsPreviousCall(History const& history) const
+{
+    if (history.length() != _previous_history_length + 1
+        || history.back().action->index() != _previous_action)
+    {
+        return false;
+    }
+
+    // (compared on index: the actions and observations may have been copied)
+    return lastStep(history, history.length() - 1) == _previous_last_step;
+}
+
+std::pair<int, int> MCTS::lastStep(History const& history, size_t length)
+{
+    assert(length <= history.length());
+
+    if (length == 0)
+    {
+        return {-1, -1};
+    }
+
+    auto const step = history[static_cast<int>(length) - 1];
+    return {step.action->index(), step.observation->index()};
+}
+
+bool MCTS::mayAddChild(ActionNode* n, int a) const
+{
+    if (_pw_k <= 0)
+    {
+        return true;
+    }
+
+    auto const max_children = std::max(1.0, _pw_k * std::pow(n->visited(a) + 1, _pw_alpha));
+    return n->chanceNode(a).numChildren() < max_children;
+}
+
+bool MCTS::mayExpand(searchContext const& c, ActionNode* n, int a) const
+{
+    if (_max_nodes > 0 && c.action_nodes.size() >= _max_nodes)
+    {
+        return false;
+    }
+
+    if (_max_bytes == 0)
+    {
+        return true;
+    }
+
+    // assumes the new node has as many legal actions as its parent, the chance node it is added
+    // to may need its children map (or grow its heap table), and the arena may pad each (of 6)
+    // allocations to alignment
+    auto const max_bytes = ActionNode::bytes(n->numChildren()) + ChanceNode::childrenBytes()
+                           + n->chanceNode(a).newChildHeapBytes()
+                           + 6 * (alignof(std::max_align_t) - 1);
+
+    return c.node_arena.bytesAllocated() + c.heap_bytes + max_bytes <= _max_bytes;
+}
+
+double MCTS::logVisits(int m) const
+{
+    assert(m >= 0);
+
+    return (m < _n) ? _log_table[m] : log1p(m);
+}
+
+int MCTS::selectChanceNodeUCB(searchContext& c, ActionNode* n, UCBExploration exploration_option)
+    const
+{
+    assert(n != nullptr);
+
+    return n->selectUCB(
+        _u,
+        logVisits(n->visited()),
+        exploration_option == UCBExploration::ON,
+        &c.ucb_values);
+}
+
+void MCTS::fillHistograms(std::vector<std::vector<int>>& histograms, ActionNode* n, int node_depth)
+    const
+{
+    // re-used trees may be deeper than the search of this call went
+    if (node_depth >= static_cast<int>(histograms.size()))
+    {
+        return;
+    }
+
+    for (auto a = 0; a < n->numChildren(); ++a)
+    {
+        auto& chance_node = n->chanceNode(a);
+
+        histograms[node_depth][chance_node._action->index()] += n->visited(a);
+
+        for (auto& action_node : chance_node)
+        {
+            fillHistograms(histograms, action_node.second, node_depth + 1);
+        }
+    }
+}
+
+ActionNode* MCTS::createActionNode(searchContext& c, std::vector<Action const*> const& actions)
+    const
+{
+    c.stats.num_action_nodes++;
+
+    // `action_nodes` and `node_arena` are part of a private member that will
+    // persist over multiple planning calls, so over time we expect there is
+    // no more need for re-allocating memory due to 'growing'
+    c.action_nodes.emplace_back(c.node_arena.create<ActionNode>(actions, &c.node_arena));
+
+    return c.action_nodes.back();
+}
+
+Action const*& MCTS::internedAction(searchContext& c, int i)
+{
+    assert(i >= 0);
+
+    if (static_cast<size_t>(i) >= c.action_table.size())
+    {
+        c.action_table.resize(i + 1, nullptr);
+    }
+
+    return c.action_table[i];
+}
+
+void MCTS::initiateLogTable()
+{
+    for (auto m = 0; m < _n; ++m) { _log_table[m] = log1p(m); }
+}
+
+MCTS::RolloutPolicy MCTS::rolloutPolicy(std::string const& name, std::string const& planner)
+{
+    if (name == "random")
+        return RolloutPolicy::RANDOM;
+    if (name == "heuristic")
+        return RolloutPolicy::HEURISTIC;
+    if (name == "truncated")
+        return RolloutPolicy::TRUNCATED;
+    if (name == "value-table")
+        return RolloutPolicy::VALUE_TABLE;
+
+    throw "cannot initiate " + planner + " with " + name
+        + " rollouts, must be 'random', 'heuristic', 'truncated' or 'value-table'";
+}
+
+size_t MCTS::perContext(long limit, int num_threads)
+{
+    if (limit <= 0)
+    {
+        return 0;
+    }
+
+    // rounded up, such that a limit is never turned into no limit
+    return static_cast<size_t>((limit + std::max(num_threads, 1) - 1) / std::max(num_threads, 1));
+}
+
+std::vector<double> MCTS::readValueTable(std::string const& path, std::string const& planner)
+{
+    std::ifstream f(path);
+
+    if (!f)
+    {
+        throw "cannot initiate " + planner + ": failed to open value table " + path;
+    }
+
+    std::vector<double> const values(
+        (std::istream_iterator<double>(f)), std::istream_iterator<double>());
+
+    if (values.empty() || !f.eof())
+    {
+        throw "cannot initiate " + planner + ": " + path + " is not a list of values";
+    }
+
+    return values;
+}
+
+double MCTS::tableValue(State const* s) const
+{
+    if (s->index() < 0 || s->index() >= static_cast<int>(_value_table.size()))
+    {
+        throw _name + " cannot look up the value of state " + s->toString() + " in a table of "
+            + std::to_string(_value_table.size()) + " values";
+    }
+
+    return _value_table[s->index()];
+}
+
+} // namespace planners
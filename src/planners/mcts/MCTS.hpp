@@ -0,0 +1,1253 @@
+#ifndef MCTS_HPP
+#define MCTS_HPP
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <future>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "easylogging++.h"
+
+#include "environment/Action.hpp"
+#include "environment/Discount.hpp"
+#include "environment/History.hpp"
+#include "environment/Observation.hpp"
+#include "environment/Return.hpp"
+#include "environment/Reward.hpp"
+#include "environment/State.hpp"
+#include "environment/Terminal.hpp"
+#include "planners/Telemetry.hpp"
+#include "planners/mcts/MCTSTreeNodes.hpp"
+#include "planners/mcts/TranspositionTable.hpp"
+#include "utils/Arena.hpp"
+#include "utils/Entropy.hpp"
+#include "utils/random.hpp"
+class POMDP;
+
+namespace configurations {
+struct Conf;
+}
+
+namespace planners {
+
+/**
+ * @brief The PO-UCT search, shared by `POUCT` and `RBAPOUCT`
+ *
+ * The search is templated on the simulator it plans with, such that calls
+ * to the (concrete) domain are resolved at compile time. A simulator
+ * provides the part of the `POMDP` interface the search needs:
+ *
+ * - `step(State const**, Action const*, Observation const**, Reward*)`
+ * - `generateRandomAction(State const*)` and `addLegalActions(State const*, std::vector*)`
+ * - `generateHeuristicAction(State const*)` and `heuristicValue(State const*, int)`
+ * - `copyAction`, `releaseAction` and `releaseObservation`
+ * - `domain()`: the `POMDP` that allocates (and releases) its actions
+ *
+ * and decides which states the simulations start from:
+ *
+ * - `sampleRootState()`: returns a state (owned by the belief) to determine the legal actions
+ * - `sampleState()`: returns a state to simulate from, owned by the search
+ * - `releaseState(State const*)`: returns the state at the end of a simulation
+ *
+ * Note that `sampleState` is called by all search threads simultaneously
+ * when searching in parallel.
+ *
+ * Which simulator (and thus domain type) is used may differ per call to
+ * `selectAction`, the tree and its memory are independent of it.
+ **/
+class MCTS
+{
+public:
+    /**
+     * @brief sets up the search for the configurations in `c`
+     *
+     * `name` identifies the planner in log and error messages
+     **/
+    MCTS(configurations::Conf const& c, std::string name);
+    ~MCTS();
+
+    MCTS(MCTS const&) = delete;
+    MCTS& operator=(MCTS const&) = delete;
+
+    /**
+     * @brief searches from the belief (as sampled by `simulator`) and returns the best action
+     *
+     * The `history` is used to know how far the horizon is, and to find the
+     * node of the real action and observation when reusing the tree.
+     **/
+    template<typename Simulator>
+    Action const* selectAction(Simulator const& simulator, History const& history) const;
+
+    /**
+     * @brief writes a `Telemetry` record to `sink` after each `selectAction` (nullptr to stop)
+     *
+     * The time split is only measured while a sink is set, since it
+     * requires reading the clock for every simulated step.
+     **/
+    void telemetry(TelemetrySink* sink);
+
+    /**
+     * @brief returns log(1 + m) for the visit count `m` of a parent node, as used by UCB
+     *
+     * Looked up for (the usual) m < _n, computed otherwise
+     **/
+    double logVisits(int m) const;
+
+private:
+    enum UCBExploration { ON, OFF };
+    enum RolloutPolicy { RANDOM, HEURISTIC, TRUNCATED, VALUE_TABLE };
+
+    // params
+    std::string const _name; // name of the planner in messages
+    int const _n; // number of simulations
+    int const _max_depth; // max depth of the search tree
+    int const _h; // horizon of the problem
+    double const _u; // exploration constant
+    Discount const _discount; // discount used during simulations
+    int const _num_threads; // number of search threads
+    bool const _tree_parallel; // whether threads search in the same tree
+    bool const _reuse_tree; // whether to continue from the previous tree in the next call
+    std::chrono::milliseconds const _time_budget; // time per call, replaces `_n` when positive
+    double const _pw_k; // observation progressive widening factor, disabled if 0
+    double const _pw_alpha; // observation progressive widening exponent
+    RolloutPolicy const _rollout_policy; // how new leaves are evaluated
+    int const _rollout_depth; // max number of steps of a truncated rollout
+    size_t const _transposition_size; // entries in the transposition table, disabled if 0
+    int const _transposition_steps; // number of last steps that identify a transposition
+    size_t const _max_nodes; // max number of action nodes per search context, unlimited if 0
+    size_t const _max_bytes; // max bytes of the tree per search context, unlimited if 0
+    int const _early_stop_interval; // simulations between checks of `settled`, disabled if 0
+    bool const _simulation_streams; // whether each simulation draws from its own random stream
+
+    /*
+     * @brief the value of each state (by index), used by the `VALUE_TABLE` rollout
+     *
+     * Read from file at construction, empty for other rollout policies
+     */
+    std::vector<double> const _value_table;
+
+    std::vector<double> _log_table; // quick log(1 + m) lookup table
+
+    struct treeStatistics
+    {
+        int max_tree_depth     = 0;
+        int tree_depth         = 0;
+        int num_action_nodes   = 0;
+        int num_simulations    = 0;
+        int num_saved          = 0; // simulations not performed because the root was settled
+        int num_reused         = 0; // visits of the root carried over from the previous tree
+        int num_transpositions = 0;
+        int num_unexpanded     = 0; // leaves not added because the tree was full
+        long num_rollout_steps = 0;
+
+        // only measured when reporting telemetry
+        std::chrono::steady_clock::duration search_time  = {};
+        std::chrono::steady_clock::duration step_time    = {};
+        std::chrono::steady_clock::duration rollout_time = {};
+    };
+
+    // where to report the statistics of each call, if anywhere
+    TelemetrySink* _telemetry = nullptr;
+
+    /*
+     * @brief the memory used by a single search (thread)
+     *
+     * When searching in parallel, every thread simulates from independently
+     * sampled states, either in its own tree (root-parallelization) or in a
+     * shared tree (tree-parallelization). All data that is private to a
+     * thread is stored in a context, one for each thread, including the
+     * action nodes it created (also when they are part of the shared tree).
+     * The (single threaded) default search simply uses the first.
+     *
+     * @see `selectAction`
+     */
+    struct searchContext
+    {
+        /*
+         * @brief the memory in which the nodes of the tree are allocated
+         *
+         * Both the `ActionNode` and their `ChanceNode` children are bump
+         * allocated in here, which avoids a heap allocation per node and keeps
+         * (nodes created after each other in) the tree contiguous in memory.
+         * The arena is reset after each planning call, but keeps its memory,
+         * so over time there is no more need to allocate at all.
+         *
+         * @see `createActionNode` and `freeTree`
+         */
+        utils::Arena node_arena = utils::Arena();
+
+        /*
+         * @brief the memory the children maps of the tree allocated on the heap
+         *
+         * Children maps spill over into a heap table once a chance node has
+         * more than a few children, which counts towards `_max_bytes` as well.
+         *
+         * @see `ChanceNode::addChild`
+         */
+        size_t heap_bytes = 0;
+
+        /*
+         * @brief all action nodes that make up the tree
+         *
+         * All action nodes created in `node_arena` are pushed directly on
+         * this vector, so that they (and the actions in their chance nodes)
+         * can be cleaned up before resetting the arena.
+         *
+         * @see `createActionNode`
+         */
+        std::vector<ActionNode*> action_nodes = {};
+
+        /*
+         * @brief memory efficient holder for actions
+         *
+         * During planning there is often a need to store actions in an array.
+         * Instead of building up this array every time, we keep this
+         * container around instead.
+         *
+         * Note that memory management of `Action` is done by `POMDP`, so we should
+         * not try to keep a vector of (non-pointer) `Action`.
+         *
+         * @see `POMDP::addLegalActions`
+         */
+        std::vector<Action const*> actions = {};
+
+        /*
+         * @brief the actions of the nodes created by this context, by index
+         *
+         * Chance nodes do not own their action, but share the one interned
+         * here (per tree, as the domain may allocate actions), such that
+         * actions are not kept per node and are released at once in `freeTree`.
+         *
+         * @see `addLegalActions` and `intern`
+         */
+        std::vector<Action const*> action_table = {};
+
+        /*
+         * @brief memory to compute the UCB values of the children of a node in
+         *
+         * Used in `selectChanceNodeUCB` (by `ActionNode::selectUCB`), which
+         * fills it over and over, so it makes sense to instead keep a global
+         * vector to reduce memory (re-)allocation.
+         */
+        std::vector<double> ucb_values = {};
+
+        /*
+         * @brief the nodes created by this context, by their last steps
+         *
+         * Only used when `_transposition_size` > 0, together with `path`:
+         * the (action, observation) indices from the root to the current node
+         * in the simulation.
+         *
+         * @see `traverseChanceNode`
+         */
+        TranspositionTable transpositions     = TranspositionTable();
+        std::vector<std::pair<int, int>> path = {};
+
+        treeStatistics stats = {};
+    };
+
+    /*
+     * @brief one search context per thread
+     *
+     * This field is mutable, since it is simply an internal data structure
+     * *that will chance* during constant operations (planning).
+     */
+    mutable std::vector<searchContext> _contexts;
+
+    /*
+     * @brief the moment the current planning call must return (if `_time_budget` is set)
+     *
+     * Set at the start of `selectAction`, only read by the search (threads)
+     */
+    mutable std::chrono::steady_clock::time_point _deadline = {};
+
+    /*
+     * @brief the seed of the streams of the simulations (if `_simulation_streams`)
+     *
+     * Drawn at the start of `selectAction`, only read by the search (threads)
+     */
+    mutable std::uint64_t _simulation_seed = 0;
+
+    /*
+     * @brief the root of the previous search, kept when reusing the tree
+     *
+     * When reusing trees (`_reuse_tree`) the tree of a `selectAction` call
+     * is not freed, but kept in the contexts until the next call. Then the
+     * (sub) tree under the real action and observation is promoted to be
+     * the new root, and the rest is freed. The length and last step of the
+     * history, and the picked action, are stored to recognize whether the
+     * next call indeed follows up on this one.
+     *
+     * The kept tree holds actions interned from `_previous_domain`, which is
+     * not owned: the domain must outlive the planner when reusing the tree,
+     * so that the destructor can free a tree that was kept.
+     *
+     * @see `createRoot`
+     */
+    mutable ActionNode* _previous_root              = nullptr;
+    mutable size_t _previous_history_length         = 0;
+    mutable std::pair<int, int> _previous_last_step = {-1, -1};
+    mutable int _previous_action                    = -1;
+    mutable POMDP const* _previous_domain           = nullptr;
+
+    /*
+     * @brief memory to copy the promoted sub tree in when reusing the tree
+     *
+     * Swapped with the main context after the copy, such that the memory of
+     * the previous tree can be re-used in the next call.
+     */
+    mutable searchContext _spare_context = searchContext();
+
+    /** @brief returns the next chance node based on current statistics in
+     * action
+     *
+     * This represents the tree-policy: given the current (action) node `n`, we
+     * aim to pick the 'best' action. This best action results in the next
+     * `ChanceNode`, also called 'after states' in RL. The best action is
+     * picked with UCB (if `exploration_option == ON`).
+     *
+     * Should be called in conjuction with actually traversing the tree,
+     * `traverseActionNode` and `traverseChanceNode`
+     *
+     * @param[in] c: context of the search (scratch memory)
+     * @param[in] n: current node we are at to pick next action/`ChanceNode`
+     * @param[in] exploration_option: whether to apply exploration bonus
+     *
+     * @return the index of the 'best' `ChanceNode` child of `n`
+     *
+     **/
+    int selectChanceNodeUCB(
+        searchContext& c,
+        ActionNode* n,
+        UCBExploration exploration_option) const;
+
+    /**
+     * @brief Traverses recursively the tree from node `n`
+     *
+     * We are (recursively) traversing the current tree and at `ActionNode`
+     * `n`. From here on, we pick an `Action` using `UCB`
+     * (`selectChanceNodeUCB`).
+     *
+     * Note that the input state `s` is const, which seems odd knowing that it
+     * gets updated during simulations. This is this way because *all* memory
+     * management of states are left to the `simulator`, and thus the rest of the
+     * program (including this part) may not modify it.
+     *
+     * @param[in] c: context of the search (tree memory & statistics)
+     * @param[in] n: current node to continue traversing from
+     * @param[in] simulator: used to simulate with
+     * @param[in] s: current state (const to avoid modifications outside of `simulator`)
+     * @param[in] depth_to_go: max depth *from this point on-wards*
+     *
+     * @return the accumulated (discounted) reward from this point on-wards
+     **/
+    template<typename Simulator>
+    Return traverseActionNode(
+        searchContext& c,
+        ActionNode* n,
+        State const* s,
+        Simulator const& simulator,
+        int depth_to_go) const;
+
+    /**
+     * @brief Traverses recursively the tree from node `n`
+     *
+     * We are (recursively) traversing the current tree and at `ChanceNode`
+     * `a` of `n`. From here on, we simulate a step using `simulator` on state
+     * `s` using `Action` stored in the chance node. This will determine the
+     * next `ActionNode` we will traverse (through `traverseActionNode`).
+     *
+     * Note that here it is possible that either the step is terminal, or that
+     * the child `ActionNode` (associated with `Observation` generated in
+     * simulation step) does not exist. So it is possible to exit the recursion
+     * here and possibly continue with expand and evaluating (`rollout`) the
+     * leaf.
+     *
+     * Unless the chance node may not grow (progressive widening, see
+     * `mayAddChild`): then the simulation continues in one of the existing
+     * children instead, which keeps the tree narrow (and deep) in domains
+     * where nearly every step generates a new observation.
+     *
+     * The same holds once the tree is full (see `mayExpand`), except that
+     * the leaf is evaluated with a rollout when there is no child yet.
+     *
+     * With a transposition table, a new child is first looked up by the last
+     * `_transposition_steps` actions and observations (and remaining depth):
+     * if an equivalent node exists, then it is shared (and traversed) instead
+     * of creating a leaf. This assumes that such nodes have the same legal
+     * actions.
+     *
+     * Note that the input state `s` is const, which seems odd knowing that it
+     * gets updated during simulations. This is this way because *all* memory
+     * management of states are left to the `simulator`, and thus the rest of the
+     * program (including this part) may not modify it.
+     *
+     * @param[in] c: context of the search (tree memory & statistics)
+     * @param[in] n: action node that holds (the statistics of) the chance node
+     * @param[in] a: index of the chance node in `n` to continue traversing from
+     * @param[in] simulator: used to simulate with
+     * @param[in] s: current state (const to avoid modifications outside of `simulator`)
+     * @param[in] depth_to_go: max depth *from this point on-wards*
+     *
+     * @return the accumulated (discounted) reward from this point on-wards
+     **/
+    template<typename Simulator>
+    Return traverseChanceNode(
+        searchContext& c,
+        ActionNode* n,
+        int a,
+        State const* s,
+        Simulator const& simulator,
+        int depth_to_go) const;
+
+    /**
+     * @brief returns whether chance node `a` of `n` may get another child
+     *
+     * With observation progressive widening (`_pw_k` > 0) a chance node that
+     * has been visited m times can have at most max(1, k * (m + 1)^alpha)
+     * children, otherwise there is no limit.
+     **/
+    bool mayAddChild(ActionNode* n, int a) const;
+
+    /**
+     * @brief returns whether `history` continues the call of the kept tree with a single step
+     *
+     * That is, `history` is one step longer than that of the previous call,
+     * with the same last step before it, and the action picked by that call.
+     **/
+    bool followsPreviousCall(History const& history) const;
+
+    /**
+     * @brief returns the (action, observation) indices of step `length` of `history`
+     *
+     * That is the last step of the first `length` steps, or (-1, -1) if `length` is 0
+     **/
+    static std::pair<int, int> lastStep(History const& history, size_t length);
+
+    /**
+     * @brief returns whether context `c` may create another action node like `n` under `a`
+     *
+     * False once the nodes in `c` reach `_max_nodes`, or when a node with as
+     * many actions as `n` (and the growth of the children map of chance node
+     * `a`) would not fit in `_max_bytes` (both per context).
+     **/
+    bool mayExpand(searchContext const& c, ActionNode* n, int a) const;
+
+    /**
+     * @brief computes histogram of action selection in current tree
+     * starting from node depth
+     *
+     * Aggregates action densities belonging to the same tree depth
+     **/
+    void fillHistograms(
+        std::vector<std::vector<int>>& histograms,
+        ActionNode* n,
+        int node_depth = 0) const;
+
+    /**
+     * @brief evaluates a (new) leaf at state `s` with `depth_to_go` steps left
+     *
+     * Depending on `_rollout_policy`, this either rolls out with random or
+     * heuristic actions until `depth_to_go` (or termination), rolls out with
+     * heuristic actions for at most `_rollout_depth` steps and adds the
+     * heuristic value of the state at which it stopped, or simply looks up
+     * the value of `s` in `_value_table`.
+     *
+     * The heuristics are provided by the `simulator` (domain).
+     **/
+    template<typename Simulator>
+    Return rollout(searchContext& c, State const* s, Simulator const& simulator, int depth_to_go)
+        const;
+
+    /**
+     * @brief returns the number of simulations to perform in a planning call
+     *
+     * This is `_n`, unless searching until a deadline (`_time_budget`), in
+     * which case the number of simulations is unbounded.
+     **/
+    int simulationBudget() const;
+
+    /**
+     * @brief returns whether the deadline of the current planning call has passed
+     **/
+    bool outOfTime() const;
+
+    /**
+     * @brief returns whether the action picked at `root` can not change in `remaining` simulations
+     *
+     * A visit-count bound: the most visited action must have more visits
+     * than any other action would get if all remaining simulations went to
+     * it. This only holds for the action picked by visit count, which is
+     * why searches that stop early pick the most visited action.
+     **/
+    bool settled(ActionNode* root, long remaining) const;
+
+    /**
+     * @brief writes the statistics of the call that started at `start` to `_telemetry`
+     **/
+    void reportTelemetry(std::chrono::steady_clock::time_point start) const;
+
+    /**
+     * @brief performs (at most) `n` simulations from `root` with states sampled by `simulator`
+     *
+     * Stops early when out of time, or when the root is `settled` (checked
+     * every `_early_stop_interval` simulations), but always performs at least
+     * one simulation. The number performed (and saved) is stored in the
+     * statistics of `c`.
+     *
+     * The simulations are numbered from `first`: with `_simulation_streams`
+     * simulation i draws from stream i of `_simulation_seed`.
+     **/
+    template<typename Simulator>
+    void simulate(
+        searchContext& c,
+        ActionNode* root,
+        Simulator const& simulator,
+        int n,
+        long first = 0) const;
+
+    /**
+     * @brief runs the simulations in parallel and merges the root statistics into `root`
+     *
+     * Every thread builds its own tree (from a copy of the root) in its own
+     * `searchContext`, after which the statistics of the root of these trees
+     * are merged into `root`.
+     **/
+    template<typename Simulator>
+    void rootParallelSimulate(ActionNode* root, Simulator const& simulator) const;
+
+    /**
+     * @brief runs `simulate` in each thread `t` from `roots[t]` in context `t`
+     *
+     * The roots may all be the same node, in which case the threads search in
+     * the same tree (tree-parallelization). The simulations are spread evenly
+     * over the threads.
+     **/
+    template<typename Simulator>
+    void parallelSimulate(std::vector<ActionNode*> const& roots, Simulator const& simulator) const;
+
+    /**
+     * @brief returns the root to search from, re-using the previous tree when possible
+     *
+     * If the tree of the previous call contains a node for the last (real)
+     * action and observation in `history`, then that node and its sub tree
+     * are promoted to be the new root in the main context. Otherwise, and
+     * when not reusing trees, a new root is created. In both cases any other
+     * node of the previous tree is freed.
+     **/
+    template<typename Simulator>
+    ActionNode* createRoot(Simulator const& simulator, History const& history) const;
+
+    /**
+     * @brief copies `n`, including its statistics and sub tree, into context `c`
+     *
+     * Nodes that are shared (transpositions) are copied once, `copies` maps
+     * the nodes that have been copied so far to their copy.
+     **/
+    template<typename Simulator>
+    ActionNode* copyTree(
+        searchContext& c,
+        ActionNode* n,
+        Simulator const& simulator,
+        std::unordered_map<ActionNode const*, ActionNode*>* copies) const;
+
+    /**
+     * @brief creates an action node and returns a pointer to it
+     *
+     * This will create an `ActionNode` (and all appropriate `ChanceNode`
+     * children *in* it) in the arena of `c`, store it in its `action_nodes`,
+     * and return its pointer.
+     *
+     * This is an attempt at memory management of the tree. All action nodes
+     * are stored in a vector (e.g. deallocation), so this function must be
+     * called whenever a new `ActionNode` is created.
+     *
+     * @see `searchContext::action_nodes`
+     *
+     * @param[in] c: context in which to store the node
+     * @param[in] actions: all legal actions in current node, for which each a `ChanceNode` is
+     *initated
+     *
+     * @return pointer to created `ActionNode`
+     **/
+    ActionNode* createActionNode(searchContext& c, std::vector<Action const*> const& actions)
+        const;
+
+    /**
+     * @brief stores the (interned) legal actions in `s` in the `actions` of `c`
+     *
+     * The actions generated by `simulator` are interned in `c`, or released
+     * when `c` already has an action with the same index.
+     **/
+    template<typename Simulator>
+    void addLegalActions(searchContext& c, State const* s, Simulator const& simulator) const;
+
+    /**
+     * @brief returns the action interned in `c` with the index of `a`, a copy of `a` if none
+     **/
+    template<typename Simulator>
+    Action const* intern(searchContext& c, Action const* a, Simulator const& simulator) const;
+
+    /**
+     * @brief returns (a reference to) the entry of action index `i` in the table of `c`
+     *
+     * The entry is nullptr if no action with index `i` was interned (yet)
+     **/
+    static Action const*& internedAction(searchContext& c, int i);
+
+    /**
+     * @brief Deallocates memory of tree
+     *
+     * - destroys action nodes in `action_nodes` of all contexts
+     * - frees the actions interned in all contexts
+     * - resets the node arena of all contexts
+     *
+     *   @param[in] simulator: responsible (necessary) for memory management of actions
+     **/
+    template<typename Simulator>
+    void freeTree(Simulator const& simulator) const;
+
+    /**
+     * @brief sets up the quick log(1 + m) lookup table
+     **/
+    void initiateLogTable();
+
+    /**
+     * @brief returns the rollout policy described by `name`, throws if there is none
+     **/
+    static RolloutPolicy rolloutPolicy(std::string const& name, std::string const& planner);
+
+    /**
+     * @brief returns the share of each of `num_threads` search contexts of `limit` (0 if none)
+     **/
+    static size_t perContext(long limit, int num_threads);
+
+    /**
+     * @brief reads the state values (separated by whitespace) in file `path`
+     **/
+    static std::vector<double> readValueTable(std::string const& path, std::string const& planner);
+
+    /**
+     * @brief returns the value of `s` in `_value_table`
+     **/
+    double tableValue(State const* s) const;
+};
+
+template<typename Simulator>
+Action const* MCTS::selectAction(Simulator const& simulator, History const& history) const
+{
+    auto const start = std::chrono::steady_clock::now();
+    _deadline        = start + _time_budget;
+
+    for (auto& c : _contexts) { c.stats = treeStatistics(); }
+
+    // the generator of this thread is re-seeded by the simulations, and
+    // continues (reproducibly) from `resume_seed` afterwards
+    auto const resume_seed = _simulation_streams ? rnd::rng()() : 0;
+    if (_simulation_streams)
+    {
+        _simulation_seed = rnd::rng()();
+    }
+
+    // the main context holds the tree from which the action is picked
+    auto& context = _contexts[0];
+
+    auto const root      = createRoot(simulator, history);
+    auto const _nactions = root->numChildren();
+
+    // do not look further than the horizon
+    auto const max_tree_depth = std::min(_h - (int)history.length(), _max_depth);
+    for (auto& c : _contexts) { c.stats.max_tree_depth = max_tree_depth; }
+
+    // perform simulations
+    if (_num_threads == 1)
+    {
+        simulate(context, root, simulator, simulationBudget());
+    } else if (_tree_parallel)
+    {
+        parallelSimulate(std::vector<ActionNode*>(_num_threads, root), simulator);
+    } else
+    {
+        rootParallelSimulate(root, simulator);
+    }
+
+    if (_simulation_streams)
+    {
+        rnd::seedThread(resume_seed);
+    }
+
+    // pick best action, which is the most visited one if the search may have been cut short
+    auto const best        = (_early_stop_interval > 0)
+                                 ? root->mostVisited()
+                                 : selectChanceNodeUCB(context, root, UCBExploration::OFF);
+    auto const best_action = simulator.copyAction(root->chanceNode(best)._action);
+
+    assert(context.stats.num_action_nodes == (int)context.action_nodes.size());
+
+    VLOG(2) << _name << " performed " << context.stats.num_simulations << " simulations"
+            << (context.stats.num_saved > 0
+                    ? " (stopped early, saving " + std::to_string(context.stats.num_saved) + ")"
+                    : "");
+
+    if (VLOG_IS_ON(3))
+    {
+        VLOG(3) << "po-uct picked node " << root->toString(best)
+                << " at tree of depth=" << context.stats.tree_depth << " and "
+                << context.stats.num_action_nodes << " action nodes ("
+                << context.node_arena.bytesAllocated() + context.heap_bytes << " bytes, "
+                << context.stats.num_transpositions << " transpositions, "
+                << context.stats.num_unexpanded << " leaves not added to the full tree)";
+
+        VLOG(3) << "Action stats:";
+        for (auto a = 0; a < _nactions; ++a) { VLOG(3) << "\t" << root->toString(a); }
+    }
+
+    if (VLOG_IS_ON(4))
+    {
+        auto nlayers = context.stats.tree_depth + 2;
+        std::vector<double> entropies(nlayers);
+
+        std::vector<std::vector<int>> histograms(nlayers, std::vector<int>(_nactions, 0));
+
+        fillHistograms(histograms, root);
+
+        for (unsigned int i = 0; i < histograms.size(); i++)
+        {
+            // Computing percentual entropy
+            entropies[i] = ent::H(histograms[i]) / log2(_nactions);
+        }
+
+        std::stringstream ss;
+        ss << "Entropies:";
+        for (auto h : entropies)
+        {
+            ss << " " << std::fixed << std::setprecision(1) << 100 * h << "%";
+        }
+        VLOG(4) << ss.str();
+    }
+
+    if (_telemetry != nullptr)
+    {
+        reportTelemetry(start);
+    }
+
+    if (_reuse_tree)
+    {
+        _previous_root           = root;
+        _previous_history_length = history.length();
+        _previous_last_step      = lastStep(history, history.length());
+        _previous_action         = root->chanceNode(best)._action->index();
+        _previous_domain         = &simulator.domain();
+    } else
+    {
+        freeTree(simulator);
+    }
+
+    return best_action;
+}
+
+template<typename Simulator>
+ActionNode* MCTS::createRoot(Simulator const& simulator, History const& history) const
+{
+    ActionNode* root = nullptr;
+
+    if (_previous_root != nullptr)
+    {
+        // look for the node of the real action and observation in the previous tree
+        if (followsPreviousCall(history))
+        {
+            auto const& real_step       = history.back();
+            auto const real_action      = real_step.action->index();
+            auto const real_observation = real_step.observation->index();
+
+            for (auto& chance_node : *_previous_root)
+            {
+                if (chance_node._action->index() == real_action
+                    && chance_node.hasChild(real_observation))
+                {
+                    std::unordered_map<ActionNode const*, ActionNode*> copies;
+
+                    _spare_context.stats = treeStatistics();
+                    root                 = copyTree(
+                        _spare_context, chance_node.child(real_observation), simulator, &copies);
+                    break;
+                }
+            }
+        }
+
+        freeTree(simulator);
+        _previous_root   = nullptr;
+        _previous_domain = nullptr;
+
+        if (root != nullptr)
+        {
+            std::swap(_contexts[0], _spare_context);
+            _contexts[0].stats.num_reused = root->visited();
+
+            VLOG(3) << _name << " re-uses node with " << root->visited()
+                    << " visits from the previous tree";
+            return root;
+        }
+    }
+
+    auto& c = _contexts[0];
+
+    addLegalActions(c, simulator.sampleRootState(), simulator);
+    root = createActionNode(c, c.actions);
+
+    // does not leak memory: actions interned in `c`
+    c.actions.clear();
+
+    return root;
+}
+
+template<typename Simulator>
+ActionNode* MCTS::copyTree(
+    searchContext& c,
+    ActionNode* n,
+    Simulator const& simulator,
+    std::unordered_map<ActionNode const*, ActionNode*>* copies) const
+{
+    auto const copied = copies->find(n);
+    if (copied != copies->end())
+    {
+        return copied->second;
+    }
+
+    for (auto const& chance_node : *n)
+    {
+        c.actions.emplace_back(intern(c, chance_node._action, simulator));
+    }
+
+    auto const copy = createActionNode(c, c.actions);
+    c.actions.clear();
+
+    copy->mergeStatistics(*n);
+    copies->emplace(n, copy);
+
+    auto copy_chance_node = copy->begin();
+    for (auto& chance_node : *n)
+    {
+        for (auto& child : chance_node)
+        {
+            c.heap_bytes += copy_chance_node->addChild(
+                child.first, copyTree(c, child.second, simulator, copies), &c.node_arena);
+        }
+
+        ++copy_chance_node;
+    }
+
+    return copy;
+}
+
+template<typename Simulator>
+void MCTS::simulate(
+    searchContext& c,
+    ActionNode* root,
+    Simulator const& simulator,
+    int n,
+    long first) const
+{
+    auto const start = (_telemetry != nullptr) ? std::chrono::steady_clock::now()
+                                               : std::chrono::steady_clock::time_point();
+
+    // in a shared tree, the other threads simulate (about) as much as this one
+    auto const num_sharing = _tree_parallel ? _num_threads : 1;
+
+    auto i = 0;
+    for (; i < n && (i == 0 || !outOfTime()); ++i)
+    {
+        if (_early_stop_interval > 0 && i > 0 && i % _early_stop_interval == 0
+            && settled(root, static_cast<long>(n - i) * num_sharing))
+        {
+            c.stats.num_saved += n - i;
+            break;
+        }
+
+        if (_simulation_streams)
+        {
+            rnd::seedSimulation(_simulation_seed, first + i);
+        }
+
+        auto const state = simulator.sampleState();
+
+        VLOG(4) << _name << " sim " << i + 1 << "/" << n << ": s_0=" << state->toString();
+        auto r = traverseActionNode(c, root, state, simulator, c.stats.max_tree_depth);
+        VLOG(4) << _name << " sim " << i + 1 << "/" << n << "returned :" << r.toDouble();
+    }
+
+    c.stats.num_simulations += i;
+
+    if (_telemetry != nullptr)
+    {
+        c.stats.search_time += std::chrono::steady_clock::now() - start;
+    }
+}
+
+template<typename Simulator>
+void MCTS::rootParallelSimulate(ActionNode* root, Simulator const& simulator) const
+{
+    assert(_num_threads > 1 && static_cast<int>(_contexts.size()) == _num_threads);
+
+    std::vector<ActionNode*> roots({root});
+
+    // setup a root per thread (with their own copies of the actions)
+    for (auto t = 1; t < _num_threads; ++t)
+    {
+        auto& c = _contexts[t];
+        for (auto const& chance_node : *root)
+        {
+            c.actions.emplace_back(intern(c, chance_node._action, simulator));
+        }
+
+        roots.emplace_back(createActionNode(c, c.actions));
+        c.actions.clear();
+    }
+
+    parallelSimulate(roots, simulator);
+
+    for (auto t = 1; t < _num_threads; ++t) { root->mergeStatistics(*roots[t]); }
+
+    VLOG(4) << _name << " merged the root statistics of " << _num_threads << " trees";
+}
+
+template<typename Simulator>
+void MCTS::parallelSimulate(std::vector<ActionNode*> const& roots, Simulator const& simulator) const
+{
+    assert(_num_threads > 1 && static_cast<int>(_contexts.size()) == _num_threads);
+    assert(static_cast<int>(roots.size()) == _num_threads);
+
+    std::vector<std::future<void>> workers;
+
+    auto const budget = simulationBudget();
+
+    // thread t draws from stream t of a seed drawn here, such that runs are
+    // reproducible given the main seed (and number of threads)
+    auto const seed = rnd::rng()();
+
+    for (auto t = 0; t < _num_threads; ++t)
+    {
+        auto const n = budget / _num_threads + static_cast<int>(t < budget % _num_threads);
+
+        // the simulations of thread t are numbered after those of threads 0..t-1
+        auto const first = static_cast<long>(t) * (budget / _num_threads)
+                           + std::min(t, budget % _num_threads);
+
+        workers.emplace_back(
+            std::async(std::launch::async, [this, t, n, first, seed, &roots, &simulator] {
+                rnd::seedStream(seed, t);
+                simulate(_contexts[t], roots[t], simulator, n, first);
+            }));
+    }
+
+    // get() re-throws whatever went wrong in the thread
+    for (auto& w : workers) { w.get(); }
+
+    for (auto t = 1; t < _num_threads; ++t)
+    {
+        _contexts[0].stats.tree_depth =
+            std::max(_contexts[0].stats.tree_depth, _contexts[t].stats.tree_depth);
+        _contexts[0].stats.num_simulations += _contexts[t].stats.num_simulations;
+        _contexts[0].stats.num_saved += _contexts[t].stats.num_saved;
+        _contexts[0].stats.num_transpositions += _contexts[t].stats.num_transpositions;
+        _contexts[0].stats.num_rollout_steps += _contexts[t].stats.num_rollout_steps;
+        _contexts[0].stats.search_time += _contexts[t].stats.search_time;
+        _contexts[0].stats.step_time += _contexts[t].stats.step_time;
+        _contexts[0].stats.rollout_time += _contexts[t].stats.rollout_time;
+    }
+}
+
+template<typename Simulator>
+Return MCTS::traverseActionNode(
+    searchContext& c,
+    ActionNode* n,
+    State const* s,
+    Simulator const& simulator,
+    int depth_to_go) const
+{
+    assert(n != nullptr && s != nullptr);
+    assert(depth_to_go >= 0);
+
+    VLOG(5) << "at depth " << c.stats.max_tree_depth - depth_to_go << " in action node "
+            << n->toString();
+
+    c.stats.tree_depth = std::max(c.stats.tree_depth, c.stats.max_tree_depth - depth_to_go);
+
+    if (depth_to_go == 0)
+    {
+        simulator.releaseState(s);
+        return Return(0);
+    }
+
+    auto const a = selectChanceNodeUCB(c, n, UCBExploration::ON);
+
+    // discourage other threads from following the same path in the shared tree
+    if (_tree_parallel)
+    {
+        n->addVirtualLoss(a);
+    }
+
+    auto const ret = traverseChanceNode(c, n, a, s, simulator, depth_to_go);
+
+    if (_tree_parallel)
+    {
+        n->removeVirtualLoss(a);
+    }
+
+    n->addVisit();
+    return ret;
+}
+
+template<typename Simulator>
+Return MCTS::traverseChanceNode(
+    searchContext& c,
+    ActionNode* n,
+    int a,
+    State const* s,
+    Simulator const& simulator,
+    int depth_to_go) const
+{
+    assert(n != nullptr && s != nullptr);
+    assert(depth_to_go > 0);
+
+    VLOG(5) << "at depth " << c.stats.max_tree_depth - depth_to_go << " in chance node "
+            << n->toString(a);
+
+    auto& chance_node = n->chanceNode(a);
+
+    Observation const* o(nullptr);
+    Reward immediate_reward(0);
+    Return delayed_return;
+
+    auto const step_start = (_telemetry != nullptr) ? std::chrono::steady_clock::now()
+                                                    : std::chrono::steady_clock::time_point();
+
+    auto terminal = simulator.step(&s, chance_node._action, &o, &immediate_reward);
+
+    if (_telemetry != nullptr)
+    {
+        c.stats.step_time += std::chrono::steady_clock::now() - step_start;
+    }
+
+    // continue traverse if not terminated
+    if (!terminal.terminated())
+    {
+        // keep track of the path for the transposition table
+        if (_transposition_size > 0)
+        {
+            c.path.emplace_back(chance_node._action->index(), o->index());
+        }
+
+        // continue in tree if node exists
+        if (chance_node.hasChild(o->index()))
+        {
+            auto const child = chance_node.child(o->index());
+            delayed_return   = traverseActionNode(c, child, s, simulator, depth_to_go - 1);
+        } else if (!mayAddChild(n, a)) // else continue in an existing node when widened enough
+        {
+            auto const child = chance_node.sampleChild();
+            delayed_return   = traverseActionNode(c, child, s, simulator, depth_to_go - 1);
+        } else if (!mayExpand(c, n, a)) // else continue in the existing tree when it is full
+        {
+            c.stats.num_unexpanded++;
+
+            if (chance_node.numChildren() > 0)
+            {
+                auto const child = chance_node.sampleChild();
+                delayed_return   = traverseActionNode(c, child, s, simulator, depth_to_go - 1);
+            } else
+            {
+                delayed_return = rollout(c, s, simulator, depth_to_go - 1);
+            }
+        } else if (_transposition_size == 0) // else create leaf and end with rollout
+        {
+            addLegalActions(c, s, simulator);
+            auto const child = createActionNode(c, c.actions);
+            c.heap_bytes += chance_node.addChild(o->index(), child, &c.node_arena);
+
+            // does not leak memory, actions interned in `c`
+            c.actions.clear();
+
+            delayed_return = rollout(c, s, simulator, depth_to_go - 1);
+        } else // else share an equivalent node, or create a leaf (and remember it)
+        {
+            auto const key = TranspositionTable::key(c.path, _transposition_steps, depth_to_go - 1);
+            auto child     = c.transpositions.find(key);
+
+            if (child != nullptr)
+            {
+                c.stats.num_transpositions++;
+
+                c.heap_bytes += chance_node.addChild(o->index(), child, &c.node_arena);
+                delayed_return = traverseActionNode(c, child, s, simulator, depth_to_go - 1);
+            } else
+            {
+                addLegalActions(c, s, simulator);
+                child = createActionNode(c, c.actions);
+
+                // does not leak memory, actions interned in `c`
+                c.actions.clear();
+
+                c.heap_bytes += chance_node.addChild(o->index(), child, &c.node_arena);
+                c.transpositions.insert(key, child);
+
+                delayed_return = rollout(c, s, simulator, depth_to_go - 1);
+            }
+        }
+
+        if (_transposition_size > 0)
+        {
+            c.path.pop_back();
+        }
+    } else // terminal
+    {
+        simulator.releaseState(s);
+    }
+
+    // collect results
+    auto const ret = immediate_reward.toDouble() + _discount.toDouble() * delayed_return.toDouble();
+    n->addVisit(a, ret);
+
+    // return
+    simulator.releaseObservation(o);
+    return Return(ret);
+}
+
+template<typename Simulator>
+Return MCTS::rollout(searchContext& c, State const* s, Simulator const& simulator, int depth_to_go)
+    const
+{
+    assert(s != nullptr && depth_to_go >= 0);
+
+    auto const start = (_telemetry != nullptr) ? std::chrono::steady_clock::now()
+                                               : std::chrono::steady_clock::time_point();
+
+    if (_rollout_policy == VALUE_TABLE)
+    {
+        auto const value = tableValue(s);
+        simulator.releaseState(s);
+
+        if (_telemetry != nullptr)
+        {
+            c.stats.rollout_time += std::chrono::steady_clock::now() - start;
+        }
+
+        return Return(value);
+    }
+
+    auto immediate_reward = Reward(0);
+    auto ret              = Return();
+    auto t                = Terminal(false);
+    auto discount         = Discount(_discount.toDouble());
+
+    // truncated rollouts stop early
+    auto steps_to_go =
+        (_rollout_policy == TRUNCATED) ? std::min(depth_to_go, _rollout_depth) : depth_to_go;
+
+    Observation const* o;
+
+    // rollout until termination
+    while (steps_to_go > 0 && !t.terminated())
+    {
+        auto const a = (_rollout_policy == RANDOM) ? simulator.generateRandomAction(s)
+                                                   : simulator.generateHeuristicAction(s);
+        t = simulator.step(&s, a, &o, &immediate_reward);
+
+        ret.add(immediate_reward, discount);
+        discount.increment();
+
+        simulator.releaseAction(a);
+        simulator.releaseObservation(o);
+
+        depth_to_go--;
+        steps_to_go--;
+        c.stats.num_rollout_steps++;
+    }
+
+    // and estimate the return of the remaining steps
+    if (_rollout_policy == TRUNCATED && depth_to_go > 0 && !t.terminated())
+    {
+        ret.add(Reward(simulator.heuristicValue(s, depth_to_go)), discount);
+    }
+
+    simulator.releaseState(s);
+
+    if (_telemetry != nullptr)
+    {
+        c.stats.rollout_time += std::chrono::steady_clock::now() - start;
+    }
+
+    VLOG(5) << _name << " finished rollout to depth " << c.stats.max_tree_depth - depth_to_go;
+    return ret;
+}
+
+template<typename Simulator>
+void MCTS::addLegalActions(searchContext& c, State const* s, Simulator const& simulator) const
+{
+    assert(c.actions.empty());
+
+    simulator.addLegalActions(s, &c.actions);
+
+    for (auto& a : c.actions)
+    {
+        auto& interned = internedAction(c, a->index());
+
+        if (interned == nullptr)
+        {
+            interned = a;
+        } else
+        {
+            simulator.releaseAction(a);
+            a = interned;
+        }
+    }
+}
+
+template<typename Simulator>
+Action const* MCTS::intern(searchContext& c, Action const* a, Simulator const& simulator) const
+{
+    auto& interned = internedAction(c, a->index());
+
+    if (interned == nullptr)
+    {
+        interned = simulator.copyAction(a);
+    }
+
+    return interned;
+}
+
+template<typename Simulator>
+void MCTS::freeTree(Simulator const& simulator) const
+{
+    for (auto& c : _contexts)
+    {
+        for (auto& n : c.action_nodes) { n->~ActionNode(); }
+
+        for (auto& a : c.action_table)
+        {
+            if (a != nullptr)
+            {
+                simulator.releaseAction(a);
+            }
+        }
+
+        c.action_nodes.clear();
+        c.action_table.clear();
+        c.node_arena.reset();
+        c.heap_bytes = 0;
+        c.transpositions.clear();
+    }
+}
+
+} // namespace planners
+
+#endif // MCTS_HPP
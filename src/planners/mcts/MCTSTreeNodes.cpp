@@ -1,46 +1,177 @@
 #include "MCTSTreeNodes.hpp"
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <new>
+
+#include "utils/Arena.hpp"
+#include "utils/random.hpp"
+
 ChanceNode::ChanceNode(Action const* a) : _action(a)
 {
     assert(a != nullptr);
 }
 
-void ChanceNode::addVisit(double r)
+ChanceNode::~ChanceNode()
 {
-    _visit_count++;
-    _q += ((r - _q) / _visit_count);
+    auto const children = _children.load();
+    if (children != nullptr)
+    {
+        children->~Children();
+    }
 }
 
-int ChanceNode::visited() const
+std::string ChanceNode::toString() const
 {
-    return _visit_count;
+    return "(a=" + _action->toString() + ")";
 }
 
-double ChanceNode::qValue() const
+ChanceNode::ChildMap::iterator ChanceNode::begin()
 {
-    return _q;
+    auto const children = _children.load(std::memory_order_acquire);
+    return (children != nullptr) ? children->map.begin() : ChildMap::iterator(nullptr, nullptr);
 }
 
-std::string ChanceNode::toString() const
+ChanceNode::ChildMap::iterator ChanceNode::end()
 {
-    return "(a=" + _action->toString() + ", q=" + std::to_string(_q)
-           + ", n=" + std::to_string(_visit_count) + ")";
+    auto const children = _children.load(std::memory_order_acquire);
+    return (children != nullptr) ? children->map.end() : ChildMap::iterator(nullptr, nullptr);
 }
 
 ActionNode* ChanceNode::child(int i)
 {
-    return _children.at(i);
+    auto const children = _children.load(std::memory_order_acquire);
+    assert(children != nullptr);
+
+    children->acquire();
+    auto const c = children->map.find(i);
+    auto const n = (c != nullptr) ? *c : nullptr;
+    children->release();
+
+    assert(n != nullptr);
+    return n;
 }
 
 bool ChanceNode::hasChild(int i) const
 {
-    return _children.count(i) != 0u;
+    auto const children = _children.load(std::memory_order_acquire);
+    if (children == nullptr)
+    {
+        return false;
+    }
+
+    children->acquire();
+    auto const has_child = children->map.contains(i);
+    children->release();
+
+    return has_child;
 }
 
-void ChanceNode::addChild(int i, ActionNode* n)
+size_t ChanceNode::addChild(int i, ActionNode* n, utils::Arena* arena)
 {
-    assert(n != nullptr);
-    _children.insert({i, n});
+    assert(n != nullptr && arena != nullptr);
+
+    auto children = _children.load(std::memory_order_acquire);
+    if (children == nullptr)
+    {
+        auto const created = arena->create<Children>();
+
+        // if another thread created the map in the mean time, then we add to theirs
+        if (_children.compare_exchange_strong(children, created, std::memory_order_acq_rel))
+        {
+            children = created;
+        } else
+        {
+            created->~Children();
+        }
+    }
+
+    // if another thread added a child for i already, then `n` is not stored
+    children->acquire();
+    auto const heap_bytes = children->map.heapBytes();
+    children->map.insert(i, n);
+    auto const growth = children->map.heapBytes() - heap_bytes;
+    children->release();
+
+    return growth;
+}
+
+size_t ChanceNode::childrenBytes()
+{
+    return sizeof(Children);
+}
+
+size_t ChanceNode::newChildHeapBytes() const
+{
+    auto const children = _children.load(std::memory_order_acquire);
+    if (children == nullptr)
+    {
+        return 0;
+    }
+
+    children->acquire();
+    auto const heap_bytes = children->map.insertionHeapBytes();
+    children->release();
+
+    return heap_bytes;
+}
+
+int ChanceNode::numChildren() const
+{
+    auto const children = _children.load(std::memory_order_acquire);
+    if (children == nullptr)
+    {
+        return 0;
+    }
+
+    children->acquire();
+    auto const num_children = children->map.size();
+    children->release();
+
+    return num_children;
+}
+
+ActionNode* ChanceNode::sampleChild()
+{
+    auto const children = _children.load(std::memory_order_acquire);
+    assert(children != nullptr);
+
+    children->acquire();
+
+    assert(children->map.size() > 0);
+
+    auto total = 0;
+    for (auto const& c : children->map) { total += 1 + c.second->visited(); }
+
+    auto sample = static_cast<int>(rnd::uniform_rand01() * total);
+
+    ActionNode* n = nullptr;
+    for (auto const& c : children->map)
+    {
+        n = c.second;
+        sample -= 1 + c.second->visited();
+
+        if (sample < 0)
+        {
+            break;
+        }
+    }
+
+    children->release();
+
+    return n;
+}
+
+void ChanceNode::Children::acquire() const
+{
+    // contention is rare and the critical sections are short, so we spin
+    while (lock.test_and_set(std::memory_order_acquire)) {}
+}
+
+void ChanceNode::Children::release() const
+{
+    lock.clear(std::memory_order_release);
 }
 
 int ActionNode::visited() const
@@ -48,12 +179,35 @@ int ActionNode::visited() const
     return _visit_count;
 }
 
-ActionNode::ActionNode(std::vector<Action const*> const& legal_actions)
+ActionNode::ActionNode(std::vector<Action const*> const& legal_actions, utils::Arena* arena) :
+        _children(arena->allocateArray<ChanceNode>(legal_actions.size())),
+        _num_children(legal_actions.size()),
+        _child_visits(arena->allocateArray<std::atomic<int>>(_num_children)),
+        _child_virtual_loss(arena->allocateArray<std::atomic<int>>(_num_children)),
+        _child_q(arena->allocateArray<std::atomic<float>>(_num_children))
 {
     assert(!legal_actions.empty());
 
-    _children.reserve(legal_actions.size());
-    for (auto const& a : legal_actions) { _children.emplace_back(ChanceNode(a)); }
+    for (size_t i = 0; i < _num_children; ++i)
+    {
+        new (&_children[i]) ChanceNode(legal_actions[i]);
+        new (&_child_visits[i]) std::atomic<int>(0);
+        new (&_child_virtual_loss[i]) std::atomic<int>(0);
+        new (&_child_q[i]) std::atomic<float>(0);
+    }
+}
+
+ActionNode::~ActionNode()
+{
+    for (auto& chance_node : *this) { chance_node.~ChanceNode(); }
+}
+
+size_t ActionNode::bytes(size_t num_actions)
+{
+    return sizeof(ActionNode)
+           + num_actions
+                 * (sizeof(ChanceNode) + 2 * sizeof(std::atomic<int>)
+                    + sizeof(std::atomic<float>));
 }
 
 void ActionNode::addVisit()
@@ -61,8 +215,201 @@ void ActionNode::addVisit()
     _visit_count++;
 }
 
+void ActionNode::addVisit(int a, double r)
+{
+    assert(a >= 0 && static_cast<size_t>(a) < _num_children);
+
+    auto const n = ++_child_visits[a];
+
+    // incremental average, retries if another thread updated q in the mean time
+    auto& q_value = _child_q[a];
+    auto q        = q_value.load();
+    while (!q_value.compare_exchange_weak(q, static_cast<float>(q + ((r - q) / n)))) {}
+}
+
+void ActionNode::addVirtualLoss(int a)
+{
+    assert(a >= 0 && static_cast<size_t>(a) < _num_children);
+    _child_virtual_loss[a]++;
+}
+
+void ActionNode::removeVirtualLoss(int a)
+{
+    assert(a >= 0 && static_cast<size_t>(a) < _num_children);
+    assert(_child_virtual_loss[a] > 0);
+
+    _child_virtual_loss[a]--;
+}
+
+int ActionNode::virtualLoss(int a) const
+{
+    assert(a >= 0 && static_cast<size_t>(a) < _num_children);
+    return _child_virtual_loss[a];
+}
+
+int ActionNode::selectUCB(double u, double log_m, bool explore, std::vector<double>* scratch) const
+{
+    assert(u >= 0 && log_m >= 0 && scratch != nullptr);
+
+    auto const n = _num_children;
+
+    // first half of the scratch memory holds the values, the second half the visits
+    scratch->resize(2 * n);
+    auto const values = scratch->data();
+    auto const visits = scratch->data() + n;
+
+    auto const max = std::numeric_limits<double>::max();
+
+    // gather the (atomic) statistics into plain arrays
+    for (size_t i = 0; i < n; ++i)
+    {
+        double const q          = _child_q[i].load(std::memory_order_relaxed);
+        auto const v            = _child_visits[i].load(std::memory_order_relaxed);
+        auto const virtual_loss = _child_virtual_loss[i].load(std::memory_order_relaxed);
+        auto const total        = v + virtual_loss;
+
+        if (explore && total == 0)
+        {
+            values[i] = max;
+        } else
+        {
+            values[i] = (virtual_loss == 0) ? q : (q * v - virtual_loss * u) / total;
+        }
+
+        // (at least 1, such that unvisited children get a finite bonus)
+        visits[i] = std::max(total, 1);
+    }
+
+    if (explore)
+    {
+        // no branches, so this loop is vectorized: the (finite) bonus does
+        // not change the max value of the children that were not visited
+        for (size_t i = 0; i < n; ++i)
+        {
+            values[i] += u * std::sqrt(log_m / visits[i]);
+        }
+    }
+
+    // argmax, counting the number of ties with the best value
+    size_t best   = 0;
+    auto num_best = 1;
+    for (size_t i = 1; i < n; ++i)
+    {
+        if (values[i] > values[best])
+        {
+            best     = i;
+            num_best = 1;
+        } else if (values[i] == values[best])
+        {
+            num_best++;
+        }
+    }
+
+    if (num_best == 1)
+    {
+        return static_cast<int>(best);
+    }
+
+    // pick random tie, starting from the first
+    auto tie = rnd::slowRandomInt(0, num_best);
+    for (auto i = best;; ++i)
+    {
+        if (values[i] == values[best] && tie-- == 0)
+        {
+            return static_cast<int>(i);
+        }
+    }
+}
+
+int ActionNode::mostVisited() const
+{
+    // argmax, counting the number of ties with the most visits
+    auto best     = 0;
+    auto num_best = 1;
+    for (auto i = 1; i < numChildren(); ++i)
+    {
+        if (visited(i) > visited(best))
+        {
+            best     = i;
+            num_best = 1;
+        } else if (visited(i) == visited(best))
+        {
+            num_best++;
+        }
+    }
+
+    // pick random tie, starting from the first
+    auto tie = (num_best == 1) ? 0 : rnd::slowRandomInt(0, num_best);
+    for (auto i = best;; ++i)
+    {
+        if (visited(i) == visited(best) && tie-- == 0)
+        {
+            return i;
+        }
+    }
+}
+
+void ActionNode::mergeStatistics(ActionNode const& other)
+{
+    assert(_num_children == other._num_children);
+
+    _visit_count += other._visit_count;
+
+    for (size_t i = 0; i < _num_children; ++i)
+    {
+        assert(_children[i]._action->index() == other._children[i]._action->index());
+
+        auto const other_visits = other._child_visits[i].load();
+        if (other_visits == 0)
+        {
+            continue;
+        }
+
+        auto const visits = _child_visits[i].load();
+        double const q    = _child_q[i].load();
+        auto const total  = visits + other_visits;
+
+        // copy (exactly) into nodes without statistics
+        _child_q[i] = (visits == 0)
+                          ? other._child_q[i].load()
+                          : static_cast<float>(q + (other._child_q[i] - q) * other_visits / total);
+        _child_visits[i] = total;
+    }
+}
+
+ChanceNode& ActionNode::chanceNode(int a)
+{
+    assert(a >= 0 && static_cast<size_t>(a) < _num_children);
+    return _children[a];
+}
+
+int ActionNode::numChildren() const
+{
+    return static_cast<int>(_num_children);
+}
+
+int ActionNode::visited(int a) const
+{
+    assert(a >= 0 && static_cast<size_t>(a) < _num_children);
+    return _child_visits[a];
+}
+
+double ActionNode::qValue(int a) const
+{
+    assert(a >= 0 && static_cast<size_t>(a) < _num_children);
+    return _child_q[a];
+}
+
 std::string ActionNode::toString() const
 {
-    return "(n=" + std::to_string(_visit_count) + ", with " + std::to_string(_children.size())
+    return "(n=" + std::to_string(_visit_count) + ", with " + std::to_string(_num_children)
            + " actions)";
 }
+
+std::string ActionNode::toString(int a) const
+{
+    assert(a >= 0 && static_cast<size_t>(a) < _num_children);
+
+    return "(a=" + _children[a]._action->toString() + ", q=" + std::to_string(_child_q[a])
+           + ", n=" + std::to_string(_child_visits[a]) + ")";
+}
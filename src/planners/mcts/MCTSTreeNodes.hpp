@@ -1,12 +1,16 @@
 #ifndef MCTSTREENODES_HPP
 #define MCTSTREENODES_HPP
 
+#include <atomic>
 #include <cassert>
 #include <string>
-#include <unordered_map>
 #include <vector>
 
 #include "environment/Action.hpp"
+#include "utils/FlatIntMap.hpp"
+namespace utils {
+class Arena;
+}
 
 /**
  * @brief Nodes used to create MCTS trees
@@ -19,6 +23,18 @@
  * When MCTS is doing an iteration and travels through the tree,
  * it should pick an action whenever it is in an action node, and
  * it should simulate a step whenever in a chance node.
+ *
+ * Nodes are allocated in an `utils::Arena`: an action node and the array of
+ * its chance nodes live contiguously in memory, and a whole tree is freed
+ * at once by resetting the arena (after destroying the nodes).
+ *
+ * The statistics of the chance nodes are stored in their parent action node,
+ * in an array per statistic, such that selecting an action (which looks at
+ * the statistics of all children) scans contiguous memory.
+ *
+ * The statistics of the nodes are atomic, and adding children is guarded,
+ * such that multiple threads can traverse (and grow) the same tree. Iterating
+ * over the children, however, is only safe once no thread is searching.
  **/
 
 // forward declaration
@@ -29,9 +45,9 @@ class ActionNode;
  *possible observation
  *
  * This node is visited whenever the corresponding action
- * in the parent ActionNode has been picked. It contains
- * statistics for how often it has been visited and what the
- * average return (q value) is
+ * in the parent ActionNode has been picked. The statistics
+ * of how often it has been visited and what the average
+ * return (q value) is are stored in the parent.
  *
  * The child nodes of this node correspond to the observations
  * that can be generated.
@@ -39,40 +55,81 @@ class ActionNode;
 class ChanceNode
 {
 private:
-    // how often this node has been visited
-    int _visit_count = 0;
-
-    // expected return when taking this action (q value)
-    double _q = 0;
-
-    // maps observation index (chance) to child node
-    std::unordered_map<int, ActionNode*> _children{};
+    using ChildMap = utils::FlatIntMap<ActionNode*, 4>;
+
+    /*
+     * @brief the children of a chance node, allocated once the first child is added
+     *
+     * Maps observation index (chance) to child node, most chance nodes only
+     * see a handful of observations which are then stored without (heap)
+     * allocation. The lock guards `map` against simultaneous modification
+     * and access.
+     */
+    struct Children
+    {
+        mutable std::atomic_flag lock = ATOMIC_FLAG_INIT;
+        ChildMap map{};
+
+        void acquire() const;
+        void release() const;
+    };
+
+    // most chance nodes (near the leaves) never get a child, so instead of
+    // storing the (large) map in place, a node only points to it
+    std::atomic<Children*> _children{nullptr};
 
 public:
+    /**
+     * @brief creates a chance node for action `a`, which must outlive the node
+     *
+     * Nodes do not own their action: the search interns one per action and
+     * tree, which all nodes of that action share.
+     **/
     explicit ChanceNode(Action const* a);
 
-    // disallow shallow copies
-    ChanceNode(ChanceNode const&) = default;
-    ChanceNode(ChanceNode&&)      = default;
-    ChanceNode& operator=(ChanceNode const&) = default;
-    ChanceNode& operator=(ChanceNode&&) = default;
+    // destroys (but does not deallocate) the children map
+    ~ChanceNode();
 
-    // registers visiting the node with return r
-    void addVisit(double r);
+    // nodes live in place in their parent `ActionNode`
+    ChanceNode(ChanceNode const&) = delete;
+    ChanceNode& operator=(ChanceNode const&) = delete;
 
     /*** iterators ***/
-    auto begin() -> decltype(_children)::iterator { return _children.begin(); }
-    auto end() -> decltype(_children)::iterator { return _children.end(); }
-    auto cbegin() const -> decltype(_children)::const_iterator const { return _children.cbegin(); }
-    auto cend() const -> decltype(_children)::const_iterator const { return _children.cend(); }
+    ChildMap::iterator begin();
+    ChildMap::iterator end();
 
     // manipulate tree functions
     ActionNode* child(int i);
     bool hasChild(int i) const;
-    void addChild(int i, ActionNode* n);
+    int numChildren() const;
 
-    int visited() const;
-    double qValue() const;
+    /**
+     * @brief adds `n` as the child for observation `i`, unless there is one already
+     *
+     * The children map is allocated in `arena` when this is the first child,
+     * which must live as long as the tree (the arena of the calling thread).
+     *
+     * @return the number of bytes the children map grew by on the heap
+     **/
+    size_t addChild(int i, ActionNode* n, utils::Arena* arena);
+
+    /**
+     * @brief returns the memory (in the arena) of the children map, allocated with the first child
+     **/
+    static size_t childrenBytes();
+
+    /**
+     * @brief returns the number of bytes the children map grows by on the heap with a new child
+     **/
+    size_t newChildHeapBytes() const;
+
+    /**
+     * @brief returns one of the children, proportionally to their visit counts (plus one)
+     *
+     * Used by progressive widening to continue in an existing branch when no
+     * more children may be added. Assumes there is at least one child.
+     **/
+    ActionNode* sampleChild();
 
     std::string toString() const;
 
@@ -84,27 +141,108 @@ class ActionNode
 {
 private:
     // how often this node has been visited
-    int _visit_count = 0;
+    std::atomic<int> _visit_count{0};
+
+    // child node per action, stored in the arena of the tree
+    ChanceNode* _children;
+    size_t const _num_children;
 
-    // maps action to child node
-    std::vector<ChanceNode> _children{};
+    // statistics of the children, stored in the arena as well:
+    // how often each was visited, the number of simulations currently
+    // traversing each, and the expected return of their action (q value),
+    // the latter in single precision to halve the memory scanned by `selectUCB`
+    std::atomic<int>* _child_visits;
+    std::atomic<int>* _child_virtual_loss;
+    std::atomic<float>* _child_q;
 
 public:
     /**
      * @brief constructs a tree with an action node for each legal action
+     *
+     * The chance nodes are allocated in `arena`, which is expected to be the
+     * one `this` is allocated in as well.
      **/
-    explicit ActionNode(std::vector<Action const*> const& legal_actions);
+    ActionNode(std::vector<Action const*> const& legal_actions, utils::Arena* arena);
+
+    // destroys (but does not deallocate) the chance nodes
+    ~ActionNode();
+
+    /**
+     * @brief returns the memory (in the arena) of an action node with `num_actions` children
+     *
+     * Includes the chance nodes and their statistics, but not alignment
+     * padding nor the children maps of the chance nodes (allocated once
+     * they get a child) and what those allocate on the heap.
+     **/
+    static size_t bytes(size_t num_actions);
+
+    ActionNode(ActionNode const&) = delete;
+    ActionNode& operator=(ActionNode const&) = delete;
 
     void addVisit();
 
+    // registers visiting the chance node of action `a` with return r
+    void addVisit(int a, double r);
+
+    /**
+     * @brief registers (and removes) a simulation that is passing through chance node `a`
+     *
+     * When multiple threads search in the same tree, a node that is being
+     * simulated by some thread should look less attractive to the other
+     * threads until the result is backed up, such that they explore other
+     * branches (virtual loss).
+     **/
+    void addVirtualLoss(int a);
+    void removeVirtualLoss(int a);
+    int virtualLoss(int a) const;
+
+    /**
+     * @brief returns the (index of the) action with the highest UCB value, ties broken randomly
+     *
+     * Computes q + u * sqrt(log_m / n) for all children at once, where
+     * `log_m` is log(1 + m) of the visit count m of this node, and returns
+     * the argmax. Children that have not been visited get the maximum value.
+     * If `explore` is false, then only the q-values are compared.
+     *
+     * Simulations that are still traversing a child (virtual loss) are
+     * counted as visits with a (pessimistic) return of -u.
+     *
+     * The loops are written such that the compiler can vectorize them,
+     * `scratch` is used as (re-usable) memory to store the values in.
+     **/
+    int selectUCB(double u, double log_m, bool explore, std::vector<double>* scratch) const;
+
+    /**
+     * @brief returns the (index of the) most visited action, ties broken randomly
+     **/
+    int mostVisited() const;
+
+    /**
+     * @brief merges the statistics of the chance nodes of `other` into ours
+     *
+     * Assumes `other` was constructed with the same legal actions (in the
+     * same order). Only the statistics of the direct children are merged,
+     * their sub-trees are left untouched.
+     **/
+    void mergeStatistics(ActionNode const& other);
+
     /*** iterators ***/
-    auto begin() -> decltype(_children)::iterator { return _children.begin(); }
-    auto end() -> decltype(_children)::iterator { return _children.end(); }
-    auto cbegin() const -> decltype(_children)::const_iterator const { return _children.cbegin(); }
-    auto cend() const -> decltype(_children)::const_iterator const { return _children.cend(); }
+    ChanceNode* begin() { return _children; }
+    ChanceNode* end() { return _children + _num_children; }
+    ChanceNode const* cbegin() const { return _children; }
+    ChanceNode const* cend() const { return _children + _num_children; }
+
+    ChanceNode& chanceNode(int a);
+    int numChildren() const;
 
     int visited() const;
+    int visited(int a) const;
+    double qValue(int a) const;
+
     std::string toString() const;
+
+    // describes chance node `a` and its statistics
+    std::string toString(int a) const;
 };
 
 #endif // MCTSTREENODES_HPP
@@ -0,0 +1,118 @@
+#include "TranspositionTable.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+#include "planners/mcts/MCTSTreeNodes.hpp"
+
+namespace planners {
+
+namespace {
+
+// number of entries per bucket
+constexpr size_t const BUCKET_SIZE = 2;
+
+// mixes the bits of `v` into `h` (as the finalizer of splitmix64)
+uint64_t mix(uint64_t h, uint64_t v)
+{
+    h ^= v + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
+
+    h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    h = (h ^ (h >> 27)) * 0x94d049bb133111ebULL;
+    return h ^ (h >> 31);
+}
+
+} // namespace
+
+TranspositionTable::TranspositionTable(size_t capacity) : _entries()
+{
+    if (capacity == 0)
+    {
+        return;
+    }
+
+    size_t num_buckets = 1;
+    while (num_buckets * BUCKET_SIZE < capacity) { num_buckets *= 2; }
+
+    _entries.resize(num_buckets * BUCKET_SIZE);
+    _bucket_mask = num_buckets - 1;
+}
+
+uint64_t
+    TranspositionTable::key(std::vector<std::pair<int, int>> const& path, int k, int depth_to_go)
+{
+    assert(k > 0 && depth_to_go >= 0);
+
+    auto h = mix(0, static_cast<uint64_t>(depth_to_go));
+
+    auto const first = path.size() - std::min(path.size(), static_cast<size_t>(k));
+    for (auto i = first; i < path.size(); ++i)
+    {
+        h = mix(h, static_cast<uint64_t>(path[i].first));
+        h = mix(h, static_cast<uint64_t>(path[i].second));
+    }
+
+    return h;
+}
+
+ActionNode* TranspositionTable::find(uint64_t key) const
+{
+    if (_entries.empty())
+    {
+        return nullptr;
+    }
+
+    auto const bucket = &_entries[(key & _bucket_mask) * BUCKET_SIZE];
+    for (size_t i = 0; i < BUCKET_SIZE; ++i)
+    {
+        if (bucket[i].node != nullptr && bucket[i].key == key)
+        {
+            return bucket[i].node;
+        }
+    }
+
+    return nullptr;
+}
+
+void TranspositionTable::insert(uint64_t key, ActionNode* n)
+{
+    assert(n != nullptr);
+
+    if (_entries.empty())
+    {
+        return;
+    }
+
+    auto const bucket = &_entries[(key & _bucket_mask) * BUCKET_SIZE];
+
+    // take an empty entry (or the one of the same key), otherwise the least visited
+    auto replace = bucket;
+    for (size_t i = 0; i < BUCKET_SIZE; ++i)
+    {
+        if (bucket[i].node == nullptr || bucket[i].key == key)
+        {
+            replace = &bucket[i];
+            break;
+        }
+
+        if (bucket[i].node->visited() < replace->node->visited())
+        {
+            replace = &bucket[i];
+        }
+    }
+
+    replace->key  = key;
+    replace->node = n;
+}
+
+void TranspositionTable::clear()
+{
+    std::fill(_entries.begin(), _entries.end(), entry());
+}
+
+size_t TranspositionTable::capacity() const
+{
+    return _entries.size();
+}
+
+} // namespace planners
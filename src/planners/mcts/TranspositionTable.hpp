@@ -0,0 +1,76 @@
+#ifndef TRANSPOSITIONTABLE_HPP
+#define TRANSPOSITIONTABLE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+class ActionNode;
+
+namespace planners {
+
+/**
+ * @brief A bounded map from (hashed) node keys to action nodes in the search tree
+ *
+ * Used by `MCTS` to recognize that a new node would be equivalent to one
+ * that already exists elsewhere in the tree (a transposition), in which case
+ * the existing node is shared instead, turning the tree into a DAG.
+ *
+ * The table has a fixed number of entries, grouped in buckets of two. A key
+ * is stored in its bucket if there is room, otherwise it replaces the entry
+ * with the fewest visits (the least search effort is lost). Only the (64
+ * bit) hash of a key is stored, so distinct keys are (very unlikely) confused.
+ *
+ * Not thread-safe: use one table per thread.
+ **/
+class TranspositionTable
+{
+public:
+    /**
+     * @brief creates a table of (about) `capacity` entries, a table of 0 entries stores nothing
+     **/
+    explicit TranspositionTable(size_t capacity = 0);
+
+    /**
+     * @brief returns the hash of the node at `depth_to_go` reached after `path`
+     *
+     * The key consists of the last `k` (action, observation) index pairs of
+     * `path`, and the number of steps that remain: nodes with the same key
+     * are considered equivalent.
+     **/
+    static uint64_t key(std::vector<std::pair<int, int>> const& path, int k, int depth_to_go);
+
+    /**
+     * @brief returns the node stored under `key`, nullptr if there is none
+     **/
+    ActionNode* find(uint64_t key) const;
+
+    /**
+     * @brief stores `n` under `key`, possibly replacing another entry
+     **/
+    void insert(uint64_t key, ActionNode* n);
+
+    /**
+     * @brief removes all entries (e.g. when the nodes are freed)
+     **/
+    void clear();
+
+    size_t capacity() const;
+
+private:
+    struct entry
+    {
+        uint64_t key    = 0;
+        ActionNode* node = nullptr;
+    };
+
+    std::vector<entry> _entries;
+
+    // number of buckets - 1 (the number of buckets is a power of 2)
+    size_t _bucket_mask = 0;
+};
+
+} // namespace planners
+
+#endif // TRANSPOSITIONTABLE_HPP
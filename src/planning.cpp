@@ -34,6 +34,15 @@ int main(int argc, char* argv[])
     /***** run program *****/
     try
     {
+        if (!conf.service.empty())
+        {
+            LOG(INFO) << "(" << conf.id << "): Starting planning service";
+            experiment::planning::serve(conf);
+            LOG(INFO) << "(" << conf.id << "): Stopped planning service";
+
+            return 0;
+        }
+
         LOG(INFO) << "(" << conf.id << "): Starting planning experiment";
 
         auto const res = experiment::planning::run(conf);
@@ -0,0 +1,82 @@
+#include "Arena.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+
+namespace utils {
+
+Arena::Arena(size_t block_size) : _block_size(block_size)
+{
+    assert(_block_size > 0);
+}
+
+void* Arena::allocate(size_t bytes, size_t alignment)
+{
+    assert(alignment > 0 && (alignment & (alignment - 1)) == 0);
+
+    // try current (and any next re-usable) block first
+    while (_current_block < _blocks.size())
+    {
+        if (auto const p = allocateFromCurrentBlock(bytes, alignment))
+        {
+            return p;
+        }
+
+        _current_block++;
+        _offset = 0;
+    }
+
+    // out of blocks: allocate one that is large enough for sure
+    auto const size = std::max(_block_size, bytes + alignment);
+    _blocks.emplace_back(block{std::unique_ptr<char[]>(new char[size]), size});
+
+    auto const p = allocateFromCurrentBlock(bytes, alignment);
+
+    assert(p != nullptr);
+    return p;
+}
+
+void Arena::reset()
+{
+    _current_block   = 0;
+    _offset          = 0;
+    _bytes_allocated = 0;
+}
+
+size_t Arena::bytesAllocated() const
+{
+    return _bytes_allocated;
+}
+
+size_t Arena::capacity() const
+{
+    size_t c = 0;
+    for (auto const& b : _blocks) { c += b.size; }
+
+    return c;
+}
+
+void* Arena::allocateFromCurrentBlock(size_t bytes, size_t alignment)
+{
+    assert(_current_block < _blocks.size());
+
+    auto& b = _blocks[_current_block];
+
+    auto const address = reinterpret_cast<std::uintptr_t>(b.memory.get()) + _offset;
+    auto const padding = (alignment - address % alignment) % alignment;
+
+    if (_offset + padding + bytes > b.size)
+    {
+        return nullptr;
+    }
+
+    auto const p = b.memory.get() + _offset + padding;
+
+    _offset += padding + bytes;
+    _bytes_allocated += bytes;
+
+    return p;
+}
+
+} // namespace utils
@@ -0,0 +1,98 @@
+#ifndef ARENA_HPP
+#define ARENA_HPP
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace utils {
+
+/**
+ * @brief A bump allocator for many small objects with the same life time
+ *
+ * Memory is handed out from large blocks by simply moving an offset forward,
+ * and can only be given back all at once through `reset`. Resetting is O(1)
+ * and keeps the blocks around, so an arena that is re-used (e.g. for a search
+ * tree per planning call) stops allocating once it has grown large enough.
+ *
+ * The arena does *not* call destructors: objects that own resources must be
+ * destroyed explicitly before calling `reset`.
+ *
+ * Not thread-safe: use one arena per thread.
+ **/
+class Arena
+{
+public:
+    explicit Arena(size_t block_size = 64 * 1024);
+
+    Arena(Arena const&) = delete;
+    Arena& operator=(Arena const&) = delete;
+    Arena(Arena&&)                 = default;
+    Arena& operator=(Arena&&) = default;
+
+    /**
+     * @brief returns `bytes` of memory aligned to `alignment`
+     **/
+    void* allocate(size_t bytes, size_t alignment);
+
+    /**
+     * @brief returns (uninitialized) memory for `n` objects of type T
+     **/
+    template<typename T>
+    T* allocateArray(size_t n)
+    {
+        return static_cast<T*>(allocate(n * sizeof(T), alignof(T)));
+    }
+
+    /**
+     * @brief constructs a T with `args` in the arena
+     **/
+    template<typename T, typename... Args>
+    T* create(Args&&... args)
+    {
+        return new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+    }
+
+    /**
+     * @brief releases all allocated memory (O(1), the blocks are kept for re-use)
+     **/
+    void reset();
+
+    /**
+     * @brief returns the number of bytes handed out since the last `reset`
+     **/
+    size_t bytesAllocated() const;
+
+    /**
+     * @brief returns the total size of the blocks owned by the arena
+     **/
+    size_t capacity() const;
+
+private:
+    struct block
+    {
+        std::unique_ptr<char[]> memory;
+        size_t size;
+    };
+
+    size_t _block_size;
+
+    std::vector<block> _blocks = {};
+
+    // the block we are currently allocating from, and where in that block
+    size_t _current_block = 0;
+    size_t _offset        = 0;
+
+    size_t _bytes_allocated = 0;
+
+    /**
+     * @brief returns pointer to `bytes` in the current block, or nullptr if they do not fit
+     **/
+    void* allocateFromCurrentBlock(size_t bytes, size_t alignment);
+};
+
+} // namespace utils
+
+#endif // ARENA_HPP
@@ -0,0 +1,263 @@
+#ifndef FLATINTMAP_HPP
+#define FLATINTMAP_HPP
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <utility>
+
+namespace utils {
+
+/**
+ * @brief A map from (non-negative) integers to values, optimized for a few elements
+ *
+ * The first `N` elements are stored in a sorted array inside the map itself,
+ * which requires no allocation and is scanned linearly on look up. Once more
+ * elements are inserted, all of them move to an open-addressing hash table
+ * (linear probing, kept at most half full).
+ *
+ * Only supports insertion and look up: elements are never removed.
+ *
+ * Iterating yields `std::pair<int, V>`, similar to `std::unordered_map`, in
+ * no particular order.
+ **/
+template<typename V, int N>
+class FlatIntMap
+{
+    static_assert(N > 0, "FlatIntMap requires some inline capacity");
+
+public:
+    using value_type = std::pair<int, V>;
+
+    /**
+     * @brief iterates over the occupied slots of a range of elements
+     **/
+    template<typename E>
+    class iteratorType : public std::iterator<std::forward_iterator_tag, E>
+    {
+    public:
+        iteratorType(E* current, E* end) : _current(current), _end(end) { skipEmpty(); }
+
+        E& operator*() const { return *_current; }
+        E* operator->() const { return _current; }
+
+        iteratorType& operator++()
+        {
+            ++_current;
+            skipEmpty();
+            return *this;
+        }
+
+        bool operator==(iteratorType const& other) const { return _current == other._current; }
+        bool operator!=(iteratorType const& other) const { return _current != other._current; }
+
+    private:
+        E* _current;
+        E* _end;
+
+        void skipEmpty()
+        {
+            while (_current != _end && _current->first == EMPTY) { ++_current; }
+        }
+    };
+
+    using iterator       = iteratorType<value_type>;
+    using const_iterator = iteratorType<value_type const>;
+
+    FlatIntMap() = default;
+
+    FlatIntMap(FlatIntMap const&) = delete;
+    FlatIntMap& operator=(FlatIntMap const&) = delete;
+
+    /**
+     * @brief returns a pointer to the value associated with `key`, nullptr if there is none
+     **/
+    V const* find(int key) const
+    {
+        assert(key >= 0);
+
+        if (_table == nullptr)
+        {
+            // sorted, so we can stop early
+            for (auto i = 0; i < _size && _inline[i].first <= key; ++i)
+            {
+                if (_inline[i].first == key)
+                {
+                    return &_inline[i].second;
+                }
+            }
+
+            return nullptr;
+        }
+
+        auto const& slot = _table[probe(key)];
+        return (slot.first == key) ? &slot.second : nullptr;
+    }
+
+    bool contains(int key) const { return find(key) != nullptr; }
+
+    /**
+     * @brief adds `value` under `key`, unless `key` is already present
+     *
+     * @return whether the element was inserted
+     **/
+    bool insert(int key, V value)
+    {
+        assert(key >= 0);
+
+        if (_table == nullptr)
+        {
+            auto i = 0;
+            while (i < _size && _inline[i].first < key) { ++i; }
+
+            if (i < _size && _inline[i].first == key)
+            {
+                return false;
+            }
+
+            if (_size < N)
+            {
+                // shift larger keys to keep the array sorted
+                for (auto j = _size; j > i; --j) { _inline[j] = std::move(_inline[j - 1]); }
+
+                _inline[i] = value_type(key, std::move(value));
+                _size++;
+
+                return true;
+            }
+
+            // inline array is full: spill over to the hash table
+            rehash(spillCapacity());
+        } else if (find(key) != nullptr)
+        {
+            return false;
+        }
+
+        if (2 * static_cast<size_t>(_size + 1) > _table_capacity)
+        {
+            rehash(2 * _table_capacity);
+        }
+
+        _table[probe(key)] = value_type(key, std::move(value));
+        _size++;
+
+        return true;
+    }
+
+    int size() const { return _size; }
+    bool empty() const { return _size == 0; }
+
+    /**
+     * @brief returns the number of bytes this map allocated on the heap
+     **/
+    size_t heapBytes() const { return _table_capacity * sizeof(value_type); }
+
+    /**
+     * @brief returns by how many bytes `heapBytes()` grows when a new key is inserted
+     **/
+    size_t insertionHeapBytes() const
+    {
+        if (_table == nullptr)
+        {
+            return (_size < N) ? 0 : spillCapacity() * sizeof(value_type);
+        }
+
+        return (2 * static_cast<size_t>(_size + 1) > _table_capacity)
+                   ? _table_capacity * sizeof(value_type)
+                   : 0;
+    }
+
+    /*** iterators ***/
+    iterator begin() { return iterator(first(), last()); }
+    iterator end() { return iterator(last(), last()); }
+    const_iterator begin() const { return const_iterator(first(), last()); }
+    const_iterator end() const { return const_iterator(last(), last()); }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+
+private:
+    static constexpr int const EMPTY = -1;
+
+    int _size = 0;
+
+    // sorted on key, only used until the map spills over into `_table`
+    value_type _inline[N]{};
+
+    // open-addressing table, `_table_capacity` is a power of 2
+    std::unique_ptr<value_type[]> _table = nullptr;
+    size_t _table_capacity               = 0;
+
+    // range of slots that (may) contain elements
+    value_type* first() { return (_table == nullptr) ? _inline : _table.get(); }
+    value_type* last()
+    {
+        return first() + ((_table == nullptr) ? static_cast<size_t>(_size) : _table_capacity);
+    }
+    value_type const* first() const { return (_table == nullptr) ? _inline : _table.get(); }
+    value_type const* last() const
+    {
+        return first() + ((_table == nullptr) ? static_cast<size_t>(_size) : _table_capacity);
+    }
+
+    /**
+     * @brief returns the capacity of the table the inline elements spill over into
+     **/
+    static size_t spillCapacity()
+    {
+        size_t capacity = 1;
+        while (capacity < 4 * N) { capacity *= 2; }
+
+        return capacity;
+    }
+
+    /**
+     * @brief returns the slot of `key` in the table, or the empty slot where it would go
+     **/
+    size_t probe(int key) const
+    {
+        assert(_table != nullptr);
+
+        auto const mask = _table_capacity - 1;
+
+        // fibonacci hashing spreads (consecutive) observation indices over the table
+        auto slot = ((static_cast<uint64_t>(key) * 11400714819323198485ull) >> 32) & mask;
+
+        while (_table[slot].first != EMPTY && _table[slot].first != key)
+        {
+            slot = (slot + 1) & mask;
+        }
+
+        return slot;
+    }
+
+    /**
+     * @brief moves all elements (inline or in the table) into a table of `capacity`
+     **/
+    void rehash(size_t capacity)
+    {
+        assert(capacity > 0 && (capacity & (capacity - 1)) == 0);
+
+        auto old_table = std::move(_table);
+        auto old_begin = (old_table == nullptr) ? _inline : old_table.get();
+        auto old_end   = (old_table == nullptr) ? _inline + _size : old_begin + _table_capacity;
+
+        _table.reset(new value_type[capacity]);
+        _table_capacity = capacity;
+
+        for (size_t i = 0; i < capacity; ++i) { _table[i].first = EMPTY; }
+
+        for (auto e = old_begin; e != old_end; ++e)
+        {
+            if (e->first != EMPTY)
+            {
+                _table[probe(e->first)] = std::move(*e);
+            }
+        }
+    }
+};
+
+} // namespace utils
+
+#endif // FLATINTMAP_HPP
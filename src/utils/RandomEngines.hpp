@@ -0,0 +1,191 @@
+#ifndef RANDOMENGINES_HPP
+#define RANDOMENGINES_HPP
+
+#include <cstdint>
+#include <limits>
+#include <random>
+
+namespace rnd {
+
+/**
+ * @brief xoshiro256**: a fast generator of 64 bit numbers with a small (32 byte) state
+ *
+ * Satisfies the requirements of a uniform random bit generator, so it can be
+ * used with the distributions in <random>, as a (much smaller and faster)
+ * replacement of `std::mt19937`.
+ *
+ * See Blackman & Vigna, "Scrambled linear pseudorandom number generators".
+ **/
+class Xoshiro256
+{
+public:
+    using result_type = std::uint64_t;
+
+    explicit Xoshiro256(result_type value = 5489u) { seed(value); }
+
+    /**
+     * @brief starts from state `s`, which must not be all zero
+     **/
+    Xoshiro256(result_type s0, result_type s1, result_type s2, result_type s3) :
+            _s{s0, s1, s2, s3}
+    {
+    }
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+    /**
+     * @brief sets the state to the output of splitmix64 seeded with `value`
+     **/
+    void seed(result_type value)
+    {
+        for (auto& s : _s)
+        {
+            value += 0x9e3779b97f4a7c15ull;
+
+            auto z = value;
+            z      = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+            z      = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+            s      = z ^ (z >> 31);
+        }
+    }
+
+    void seed(std::seed_seq& seeds)
+    {
+        std::uint32_t words[8];
+        seeds.generate(words, words + 8);
+
+        for (auto i = 0; i < 4; ++i)
+        {
+            _s[i] = (static_cast<result_type>(words[2 * i]) << 32) | words[2 * i + 1];
+        }
+
+        // the all zero state is a fixed point
+        if ((_s[0] | _s[1] | _s[2] | _s[3]) == 0)
+        {
+            seed(0);
+        }
+    }
+
+    result_type operator()()
+    {
+        auto const result = rotl(_s[1] * 5, 7) * 9;
+        auto const t      = _s[1] << 17;
+
+        _s[2] ^= _s[0];
+        _s[3] ^= _s[1];
+        _s[1] ^= _s[2];
+        _s[0] ^= _s[3];
+
+        _s[2] ^= t;
+        _s[3] = rotl(_s[3], 45);
+
+        return result;
+    }
+
+private:
+    result_type _s[4];
+
+    static result_type rotl(result_type x, int k) { return (x << k) | (x >> (64 - k)); }
+};
+
+/**
+ * @brief Philox4x32-10: a counter-based generator of 32 bit numbers
+ *
+ * Output n of stream `stream` under key `key` is a (bijective) function of
+ * (key, stream, n): there is no other state, such that any stream can be
+ * started in constant time. This makes it cheap to give every simulation its
+ * own stream (see `rnd::seedSimulation`), independent of which thread runs
+ * it or in what order.
+ *
+ * See Salmon et al., "Parallel random numbers: as easy as 1, 2, 3".
+ **/
+class Philox
+{
+public:
+    using result_type = std::uint32_t;
+
+    explicit Philox(std::uint64_t key = 5489u, std::uint64_t stream = 0) { jump(key, stream); }
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+    void seed(std::uint64_t value) { jump(value, 0); }
+
+    void seed(std::seed_seq& seeds)
+    {
+        std::uint32_t words[4];
+        seeds.generate(words, words + 4);
+
+        jump(
+            (static_cast<std::uint64_t>(words[0]) << 32) | words[1],
+            (static_cast<std::uint64_t>(words[2]) << 32) | words[3]);
+    }
+
+    /**
+     * @brief continues at the start of stream `stream` of key `key`
+     **/
+    void jump(std::uint64_t key, std::uint64_t stream)
+    {
+        _key[0]     = static_cast<std::uint32_t>(key);
+        _key[1]     = static_cast<std::uint32_t>(key >> 32);
+        _counter[0] = 0;
+        _counter[1] = 0;
+        _counter[2] = static_cast<std::uint32_t>(stream);
+        _counter[3] = static_cast<std::uint32_t>(stream >> 32);
+        _next       = 4;
+    }
+
+    result_type operator()()
+    {
+        if (_next == 4)
+        {
+            block(_counter, _key, _output);
+            _next = 0;
+
+            // the first 64 bits count the blocks within the stream
+            if (++_counter[0] == 0)
+            {
+                ++_counter[1];
+            }
+        }
+
+        return _output[_next++];
+    }
+
+    /**
+     * @brief computes the 4 outputs of counter `counter` with `key` into `out`
+     **/
+    static void
+        block(std::uint32_t const counter[4], std::uint32_t const key[2], std::uint32_t out[4])
+    {
+        std::uint32_t c[4] = {counter[0], counter[1], counter[2], counter[3]};
+        std::uint32_t k[2] = {key[0], key[1]};
+
+        for (auto round = 0; round < 10; ++round)
+        {
+            auto const p0 = static_cast<std::uint64_t>(0xD2511F53u) * c[0];
+            auto const p1 = static_cast<std::uint64_t>(0xCD9E8D57u) * c[2];
+
+            c[0] = static_cast<std::uint32_t>(p1 >> 32) ^ c[1] ^ k[0];
+            c[1] = static_cast<std::uint32_t>(p1);
+            c[2] = static_cast<std::uint32_t>(p0 >> 32) ^ c[3] ^ k[1];
+            c[3] = static_cast<std::uint32_t>(p0);
+
+            k[0] += 0x9E3779B9u;
+            k[1] += 0xBB67AE85u;
+        }
+
+        for (auto i = 0; i < 4; ++i) { out[i] = c[i]; }
+    }
+
+private:
+    std::uint32_t _key[2]     = {};
+    std::uint32_t _counter[4] = {};
+    std::uint32_t _output[4]  = {};
+    int _next                 = 4;
+};
+
+} // namespace rnd
+
+#endif // RANDOMENGINES_HPP
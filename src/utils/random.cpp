@@ -1,5 +1,12 @@
 #include "random.hpp"
 
+#include <algorithm>
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#include <immintrin.h>
+#define RND_AVX2
+#endif
+
 #include "easylogging++.h"
 
 namespace rnd {
@@ -8,12 +15,16 @@ namespace rnd {
 unsigned long random_unsigned_long[128];
 double random_double_wn[128], random_double_fn[128];
 
-std::mt19937 _rng;
+// every thread owns its own generator (and distributions), see `seedThread`
+thread_local Engine _rng;
 
-std::bernoulli_distribution bernoulli_distribution(0.5); // random bool generator
-std::uniform_real_distribution<double> uniform_probability_distribution(0, 1);
+thread_local std::bernoulli_distribution bernoulli_distribution(0.5); // random bool generator
+thread_local std::uniform_real_distribution<double> uniform_probability_distribution(0, 1);
+thread_local std::normal_distribution<double> normal_distribution(0, 1);
 
-std::uniform_int_distribution<unsigned long> uniform_long32_distribution(0, 2147483647);
+thread_local std::uniform_int_distribution<unsigned long> uniform_long32_distribution(
+    0,
+    2147483647);
 
 #if ULONG_MAX == 4294967295ul
 unsigned long long2unsignedLong(unsigned long x)
@@ -47,6 +58,7 @@ signed long randomLong()
 void initiate()
 {
     _rng.seed(time(nullptr));
+    normal_distribution.reset();
 
     // setup random lookup tables
     double tn = 3.442619855899;
@@ -80,9 +92,56 @@ void seed(std::string& seed_str)
     LOG(INFO) << "Random seed " << seed_str;
 
     _rng.seed(seed);
+    normal_distribution.reset();
 }
 
-std::mt19937& rng()
+void seedThread(std::uint64_t seed)
+{
+    _rng.seed(seed);
+    normal_distribution.reset();
+}
+
+void seedStream(std::uint64_t seed, unsigned int stream)
+{
+    std::seed_seq seeds(
+        {static_cast<std::uint32_t>(seed),
+         static_cast<std::uint32_t>(seed >> 32),
+         static_cast<std::uint32_t>(stream)});
+
+    _rng.seed(seeds);
+    normal_distribution.reset();
+}
+
+namespace {
+
+#if defined(RANDOM_ENGINE_PHILOX)
+// counter-based: starting a stream is only setting the counter
+void jump(Philox& engine, std::uint64_t seed, std::uint64_t simulation)
+{
+    engine.jump(seed, simulation);
+}
+#endif
+
+template<typename E>
+void jump(E& engine, std::uint64_t seed, std::uint64_t simulation)
+{
+    std::seed_seq seeds({static_cast<std::uint32_t>(seed),
+                         static_cast<std::uint32_t>(seed >> 32),
+                         static_cast<std::uint32_t>(simulation),
+                         static_cast<std::uint32_t>(simulation >> 32)});
+
+    engine.seed(seeds);
+}
+
+} // namespace
+
+void seedSimulation(std::uint64_t seed, std::uint64_t simulation)
+{
+    jump(_rng, seed, simulation);
+    normal_distribution.reset();
+}
+
+Engine& rng()
 {
     return _rng;
 }
@@ -121,6 +180,11 @@ double cdf(double x, double mu, double std)
     return .5 + .5 * erf((x - mu) / (std * two_squared));
 }
 
+double sample(double mu, double std)
+{
+    return mu + std * normal_distribution(_rng);
+}
+
 } // namespace normal
 
 namespace math {
@@ -212,28 +276,229 @@ double gamma(double shape)
     }
 }
 
+/**** batch gamma sampling: Marsaglia & Tsang over `gamma_lanes` shapes at a time ****/
+int const gamma_lanes = 4;
+
+static_assert(
+    Engine::min() == 0 && (Engine::max() == 0xfffffffful || Engine::max() == ~std::uint64_t(0)),
+    "the batch gamma sampler assumes the engine generates 32 or 64 random bits");
+
+/**
+ * @brief returns a draw of `randomLong32` (31 random bits), straight from the engine
+ **/
+std::uint32_t draw31Bits()
+{
+    return static_cast<std::uint32_t>(_rng() >> (Engine::max() == 0xfffffffful ? 1 : 33));
+}
+
+/**
+ * @brief proposes gamma samples for `shapes` from the fast path of the ziggurat with bits `h`
+ *
+ * Stores d = shape - 1/3 (of shapes boosted to at least 1), c = 1 / sqrt(9d),
+ * the normal x and v = (1 + cx)^3 of each lane. Returns the lanes that took
+ * the fast path (first `gamma_lanes` bits) and of those the lanes accepted
+ * by the squeeze test given uniform draws `u` (next `gamma_lanes` bits).
+ **/
+int gammaProposals(
+    float const* shapes,
+    std::uint32_t const* h,
+    double const* u,
+    double* d,
+    double* c,
+    double* x,
+    double* v)
+{
+    auto fast = 0, squeezed = 0;
+    for (auto l = 0; l < gamma_lanes; ++l)
+    {
+        // shapes below 1 are boosted by 1 and scaled afterwards
+        d[l] = (shapes[l] < 1 ? shapes[l] + 1. : shapes[l]) - 1. / 3.;
+        c[l] = 1. / sqrt(9. * d[l]);
+
+        auto const i = h[l] & 127;
+
+        x[l] = static_cast<double>(h[l]) * random_double_wn[i];
+
+        auto const cx = 1.0 + c[l] * x[l], x2 = x[l] * x[l];
+        v[l]          = cx * cx * cx;
+
+        fast |= static_cast<int>(h[l] < random_unsigned_long[i]) << l;
+        squeezed |= static_cast<int>(u[l] < 1.0 - 0.0331 * x2 * x2) << l;
+    }
+
+    return fast | ((fast & squeezed) << gamma_lanes);
+}
+
+#ifdef RND_AVX2
+__attribute__((target("avx2"))) int gammaProposalsAVX2(
+    float const* shapes,
+    std::uint32_t const* h,
+    double const* u,
+    double* d,
+    double* c,
+    double* x,
+    double* v)
+{
+    auto const one    = _mm256_set1_pd(1.0);
+    auto const shape  = _mm256_cvtps_pd(_mm_loadu_ps(shapes));
+    auto const below1 = _mm256_and_pd(_mm256_cmp_pd(shape, one, _CMP_LT_OQ), one);
+    auto const ds     = _mm256_sub_pd(_mm256_add_pd(shape, below1), _mm256_set1_pd(1. / 3.));
+    auto const cs     = _mm256_div_pd(one, _mm256_sqrt_pd(_mm256_mul_pd(_mm256_set1_pd(9.), ds)));
+
+    _mm256_storeu_pd(d, ds);
+    _mm256_storeu_pd(c, cs);
+
+    // the random bits (31) and table entries (< 2^31) fit in signed 32 and 64 bit lanes
+    auto const hs    = _mm_loadu_si128(reinterpret_cast<__m128i const*>(h));
+    auto const strip = _mm_and_si128(hs, _mm_set1_epi32(127));
+
+    auto const limit = _mm256_i32gather_epi64(
+        reinterpret_cast<long long const*>(random_unsigned_long),
+        strip,
+        sizeof(random_unsigned_long[0]));
+    auto const fast = _mm256_cmpgt_epi64(limit, _mm256_cvtepi32_epi64(hs));
+
+    auto const xs =
+        _mm256_mul_pd(_mm256_cvtepi32_pd(hs), _mm256_i32gather_pd(random_double_wn, strip, 8));
+    auto const cx = _mm256_add_pd(one, _mm256_mul_pd(cs, xs));
+    auto const x2 = _mm256_mul_pd(xs, xs);
+
+    _mm256_storeu_pd(x, xs);
+    _mm256_storeu_pd(v, _mm256_mul_pd(_mm256_mul_pd(cx, cx), cx));
+
+    auto const bound =
+        _mm256_sub_pd(one, _mm256_mul_pd(_mm256_set1_pd(0.0331), _mm256_mul_pd(x2, x2)));
+    auto const squeezed = _mm256_and_pd(
+        _mm256_castsi256_pd(fast), _mm256_cmp_pd(_mm256_loadu_pd(u), bound, _CMP_LT_OQ));
+
+    return _mm256_movemask_pd(_mm256_castsi256_pd(fast))
+           | (_mm256_movemask_pd(squeezed) << gamma_lanes);
+}
+
+bool const has_avx2 = __builtin_cpu_supports("avx2");
+#endif
+
+/**
+ * @brief finishes Marsaglia & Tsang for `d` and `c`, starting from proposal (x, u)
+ **/
+double gammaFrom(double d, double c, double x, double u)
+{
+    for (;;)
+    {
+        auto const cx = 1.0 + c * x;
+        if (cx > 0.0)
+        {
+            auto const v = cx * cx * cx, x2 = x * x;
+
+            if (u < 1.0 - 0.0331 * x2 * x2 || log(u) < .5 * x2 + d * (1. - v + log(v)))
+                return d * v;
+        }
+
+        x = randomNormal();
+        u = uniform_rand01();
+    }
+}
+
+void gammas(float const* shapes, int n, double* out)
+{
+    assert(n >= 0);
+
+    // lanes past `n` keep (ignored) harmless values
+    float lane_shapes[gamma_lanes] = {1, 1, 1, 1};
+    std::uint32_t h[gamma_lanes]   = {};
+    double d[gamma_lanes], c[gamma_lanes], x[gamma_lanes], u[gamma_lanes] = {}, v[gamma_lanes];
+
+    for (auto start = 0; start < n; start += gamma_lanes)
+    {
+        auto const lanes = std::min(gamma_lanes, n - start);
+
+        for (auto l = 0; l < lanes; ++l)
+        {
+            lane_shapes[l] = shapes[start + l];
+            assert(lane_shapes[l] >= 0);
+
+            if (lane_shapes[l] > 0)
+            {
+                h[l] = draw31Bits();
+                u[l] = uniform_rand01();
+            }
+        }
+
+#ifdef RND_AVX2
+        auto const proposals = has_avx2 ? gammaProposalsAVX2(lane_shapes, h, u, d, c, x, v)
+                                        : gammaProposals(lane_shapes, h, u, d, c, x, v);
+#else
+        auto const proposals = gammaProposals(lane_shapes, h, u, d, c, x, v);
+#endif
+
+        for (auto l = 0; l < lanes; ++l)
+        {
+            auto const shape = shapes[start + l];
+
+            // gamma(0) is 0 (gamma(1) * 0)
+            if (shape == 0)
+            {
+                out[start + l] = 0;
+                continue;
+            }
+
+            if (proposals & (1 << (gamma_lanes + l)))
+            {
+                out[start + l] = d[l] * v[l];
+            } else
+            {
+                // the slow path of the ziggurat, or a proposal that needs the full test
+                auto const normal =
+                    (proposals & (1 << l)) ? x[l] : normalRejectFix(h[l], h[l] & 127);
+                out[start + l] = gammaFrom(d[l], c[l], normal, u[l]);
+            }
+
+            if (shape < 1)
+            {
+                out[start + l] *= pow(uniform_rand01(), 1 / shape);
+            }
+        }
+    }
+}
+
 namespace Dir {
 
-int sampleFromSampledMult(float const* dir, int n)
+/**
+ * @brief samples the gammas of the n counts in dir into a (per thread) buffer and returns it
+ **/
+std::vector<double> const& sampleGammas(float const* dir, int n)
 {
-    assert(n > 0);
+    thread_local std::vector<double> gamma_samples(0);
+    gamma_samples.resize(n);
 
-    static std::vector<double> probs(0);
-    probs.clear();
-    probs.reserve(n);
+    gammas(dir, n, gamma_samples.data());
 
-    auto rand_gamma = gamma(dir[0]), gamma_sum = rand_gamma;
+    return gamma_samples;
+}
 
-    probs.emplace_back(rand_gamma);
-    // sample multinominal
+double dirichletTotal(float const* dir, int n)
+{
+    assert(n > 0);
+
+    double sum = dir[0];
     for (auto i = 1; i < n; ++i)
     {
-        rand_gamma = gamma(dir[i]);
-
-        probs.emplace_back(rand_gamma);
-        gamma_sum += rand_gamma;
+        sum += dir[i];
+        assert(dir[i] >= 0);
     }
 
+    return sum;
+}
+
+int sampleFromSampledMult(float const* dir, int n, double /*total*/)
+{
+    assert(n > 0);
+
+    auto const& probs = sampleGammas(dir, n);
+
+    double gamma_sum = 0;
+    for (auto const p : probs) { gamma_sum += p; }
+
     // if this fails, I may need to
     // catch very small probabilities
     assert(gamma_sum > 1e-300);
@@ -241,66 +506,81 @@ int sampleFromSampledMult(float const* dir, int n)
     return sampleFromMult(&probs[0], n, gamma_sum);
 }
 
-int sampleFromExpectedMult(float const* dir, int n)
+int sampleFromExpectedMult(float const* dir, int n, double total)
 {
     assert(n > 0);
-
-    double total = dir[0];
-
-    // get total
-    for (auto i = 1; i < n; ++i) total += dir[i];
-
     assert(total > 0);
+
     return sampleFromMult(&dir[0], n, total);
 }
 
 std::vector<float> expectedMult(float const* dir, int n)
 {
-    assert(n > 0);
+    auto res = std::vector<float>(n);
+    expectedMult(dir, n, res.data());
 
-    auto res = std::vector<float>();
-    res.reserve(n);
+    return res;
+}
 
-    auto sum = dir[0];
-    for (auto i = 1; i < n; ++i)
-    {
-        sum += dir[i];
-        assert(dir[i] >= 0);
-    }
+void expectedMult(float const* dir, int n, float* out)
+{
+    expectedMult(dir, n, dirichletTotal(dir, n), out);
+}
 
-    if (sum <= 1e-300) // total is too small, so return 0 distribution
+void expectedMult(float const* dir, int n, double total, float* out)
+{
+    if (total <= 1e-300) // total is too small, so return 0 distribution
     {
-        return std::vector<float>(n);
+        std::fill(out, out + n, 0.f);
+        return;
     }
 
-    for (auto i = 0; i < n; ++i) { res.emplace_back(dir[i] / sum); }
-
-    return res;
+    for (auto i = 0; i < n; ++i) { out[i] = static_cast<float>(dir[i] / total); }
 }
 
 std::vector<float> sampleMult(float const* dir, int n)
 {
-    auto res = std::vector<float>();
-    res.reserve(n);
+    auto res = std::vector<float>(n);
+    sampleMult(dir, n, res.data());
 
-    float sum = 0;
-    // initiate random gamma values
-    for (auto i = 0; i < n; ++i)
-    {
-        assert(dir[i] >= 0);
+    return res;
+}
 
-        res.emplace_back(gamma(dir[i]));
-        sum += res[i];
-    }
+void sampleMult(float const* dir, int n, float* out)
+{
+    auto const& gamma_samples = sampleGammas(dir, n);
+
+    double sum = 0;
+    for (auto const g : gamma_samples) { sum += g; }
 
     // if this fails, I may need to
     // catch very small probabilities
     assert(sum > 1e-300);
 
     // normalize
-    for (auto& x : res) x = x / sum;
+    for (auto i = 0; i < n; ++i) { out[i] = static_cast<float>(gamma_samples[i] / sum); }
+}
 
-    return res;
+double expectedProbability(float const* dir, int n, double total, int k)
+{
+    assert(k >= 0 && k < n);
+
+    // total is too small, so return 0 distribution
+    return (total <= 1e-300) ? 0 : static_cast<float>(dir[k] / total);
+}
+
+double sampledProbability(float const* dir, int n, double /*total*/, int k)
+{
+    assert(k >= 0 && k < n);
+
+    auto const& gamma_samples = sampleGammas(dir, n);
+
+    double sum = 0;
+    for (auto const g : gamma_samples) { sum += g; }
+
+    assert(sum > 1e-300);
+
+    return static_cast<float>(gamma_samples[k] / sum);
 }
 
 } // namespace Dir
@@ -4,13 +4,31 @@
 #include <cassert>
 #include <climits>
 #include <cmath>
+#include <cstdint>
 #include <cstdlib>
 #include <ctime>
 #include <random>
 #include <vector>
 
+#include "utils/RandomEngines.hpp"
+
 namespace rnd {
 
+/**
+ * @brief the generator behind `rng()`, chosen at compile time
+ *
+ * Set with the RANDOM_ENGINE cmake variable (mt19937, xoshiro256 or philox).
+ * Different engines give different (but equally reproducible) results for
+ * the same seed.
+ **/
+#if defined(RANDOM_ENGINE_XOSHIRO256)
+using Engine = Xoshiro256;
+#elif defined(RANDOM_ENGINE_PHILOX)
+using Engine = Philox;
+#else
+using Engine = std::mt19937;
+#endif
+
 /**
  * @brief initiates this (should be called once per program)
  **/
@@ -22,9 +40,54 @@ void initiate();
 void seed(std::string& seed_str);
 
 /**
- * @brief returns reference to the random number generator
+ * @brief sets the seed of the generator of the calling thread
+ *
+ * Each thread owns its own generator: `initiate` and `seed` only affect the
+ * thread they are called from. Threads spawned to do work in parallel should
+ * be seeded with this function (typically with a draw from the generator of
+ * the spawning thread, to keep results reproducible).
  **/
-std::mt19937& rng();
+void seedThread(std::uint64_t seed);
+
+/**
+ * @brief seeds the generator of the calling thread with stream `stream` of `seed`
+ *
+ * The streams of a seed are independent generators that are derived
+ * deterministically from the seed and the stream id. To split the
+ * generator of a thread over n worker threads, draw a single seed from it
+ * and seed worker i with stream i: results are then reproducible given the
+ * main seed and the number of threads.
+ **/
+void seedStream(std::uint64_t seed, unsigned int stream);
+
+/**
+ * @brief seeds the generator of the calling thread for simulation `simulation` of `seed`
+ *
+ * Like `seedStream`, but meant to be called once per simulation, such that
+ * the draws of simulation i depend only on the seed and i, and not on which
+ * thread runs it or how many draws came before. Constant time with the
+ * philox engine, other engines re-seed from a seed sequence.
+ **/
+void seedSimulation(std::uint64_t seed, std::uint64_t simulation);
+
+/**
+ * @brief returns reference to the random number generator (of the calling thread)
+ **/
+Engine& rng();
+
+/**
+ * @brief returns a draw from `distr` with the generator of the calling thread
+ *
+ * Drawing from a distribution may modify it (e.g. `std::normal_distribution`
+ * caches draws), so distributions that are shared between threads, such as
+ * those of a domain, are kept const and drawn from through a copy.
+ **/
+template<typename Distribution>
+typename Distribution::result_type draw(Distribution const& distr)
+{
+    auto d = distr;
+    return d(rng());
+}
 
 bool boolean();
 
@@ -61,6 +124,13 @@ namespace normal {
  **/
 double cdf(double x, double mu, double std);
 
+/**
+ * @brief returns a sample of the normal distribution with mean mu and standard deviation std
+ *
+ * Draws with (a distribution of) the calling thread
+ **/
+double sample(double mu, double std);
+
 } // namespace normal
 
 namespace math {
@@ -80,10 +150,23 @@ namespace sample {
  **/
 double gamma(double shape);
 
+/**
+ * @brief samples from a gamma distribution for each of the `n` shapes into `out`
+ *
+ * Same distribution as calling `gamma` for each shape, but handles the
+ * shapes in batches (testing the proposals of a batch with AVX2 when the
+ * cpu supports it) and without recursion for shapes below 1.
+ **/
+void gammas(float const* shapes, int n, double* out);
+
 namespace Dir {
 
 enum SAMPLETYPE { Regular, Expected };
-using sampleMethod = int(float const* dir, int n);
+
+/**
+ * @brief samples a category of dir of n elements, whose counts add up to total
+ **/
+using sampleMethod = int(float const* dir, int n, double total);
 
 /**
  * @brief samples from a multinominal of n elements and total probability
@@ -95,8 +178,9 @@ int sampleFromMult(T* mult, size_t n, double total_prob)
 {
 
     // get sample using uniform distribution scaled by the total
+    // sum in double, as total_prob is: float sums fall short of it by their rounding error
     auto const p = uniform_rand01() * total_prob;
-    auto sum     = mult[0];
+    double sum   = mult[0];
 
     // sample value from multinominal
     for (size_t i = 1; i < n; ++i)
@@ -114,28 +198,67 @@ int sampleFromMult(T* mult, size_t n, double total_prob)
     return n - 1;
 }
 
+/**
+ * @brief returns the total of the n counts in dir
+ **/
+double dirichletTotal(float const* dir, int n);
+
 /**
  * @brief samples from a multinominal sampled from a dirichlet
+ *
+ * Ignores total: the sampled multinominal has a total of its own
  **/
-int sampleFromSampledMult(float const* dir, int n);
+int sampleFromSampledMult(float const* dir, int n, double total);
 
 /**
  * @brief samples from dirichlet using its expectation / maximum likelyhood
  **/
-int sampleFromExpectedMult(float const* dir, int n);
+int sampleFromExpectedMult(float const* dir, int n, double total);
 
-using sampleMultinominal = std::vector<float>(float const* dir, int n);
+/**
+ * @brief returns the probability of category k of dir of n elements, whose counts add up to total
+ **/
+using categoryProbability = double(float const* dir, int n, double total, int k);
 
 /**
  * @brief returns expected multinomial distr given dir of n elements
  **/
 std::vector<float> expectedMult(float const* dir, int n);
 
+/**
+ * @brief writes the expected multinomial distr given dir of n elements into `out` (n elements)
+ **/
+void expectedMult(float const* dir, int n, float* out);
+
+/**
+ * @brief writes the expected multinomial distr given dir, whose counts add up to total, into `out`
+ **/
+void expectedMult(float const* dir, int n, double total, float* out);
+
 /**
  * @brief samples mult from dirichlet of n elements
  **/
 std::vector<float> sampleMult(float const* dir, int n);
 
+/**
+ * @brief samples mult from dirichlet of n elements into `out` (n elements)
+ **/
+void sampleMult(float const* dir, int n, float* out);
+
+/**
+ * @brief returns the probability of category k under the expected multinomial of dir
+ *
+ * Same as `expectedMult(dir, n)[k]`, in constant time
+ **/
+double expectedProbability(float const* dir, int n, double total, int k);
+
+/**
+ * @brief returns the probability of category k under a multinomial sampled from dir
+ *
+ * Same (in distribution) as `sampleMult(dir, n)[k]`, without allocating. Ignores total
+ **/
+double sampledProbability(float const* dir, int n, double total, int k);
+
 } // namespace Dir
 } // namespace sample
 } // namespace rnd
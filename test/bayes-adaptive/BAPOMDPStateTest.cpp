@@ -3,6 +3,7 @@
 #include <string>
 
 #include "bayes-adaptive/priors/BAPOMDPPrior.hpp"
+#include "bayes-adaptive/states/BASimulationState.hpp"
 #include "bayes-adaptive/states/table/BAPOMDPState.hpp"
 #include "configurations/BAConf.hpp"
 #include "domains/dummy/DummyDomain.hpp"
@@ -205,6 +206,82 @@ SCENARIO("updating BAPOMDPState", "[bayes-adaptive][flat]")
     }
 }
 
+SCENARIO("expectations of a BAPOMDPState follow its counts", "[bayes-adaptive][flat]")
+{
+    GIVEN("a BAPOMDPState for the Tiger domain that is updated and copied")
+    {
+        configurations::BAConf c;
+        c.domain_conf.domain = "episodic-tiger";
+
+        auto const d   = domains::Tiger(domains::Tiger::TigerType::EPISODIC);
+        auto const ext = bayes_adaptive::domain_extensions::TigerBAExtension(
+            domains::Tiger::TigerType::EPISODIC);
+        auto const p = factory::makeTBAPOMDPPrior(d, c);
+
+        auto const listen = IndexAction(domains::Tiger::OBSERVE);
+        auto const hear   = IndexObservation(1);
+
+        auto ba_state = static_cast<BAPOMDPState*>(p->sample(ext.getState(0)));
+
+        // copies merge the updated counts into the shared ones, so alternate the two
+        for (auto i = 0; i < 3; ++i)
+        {
+            ba_state->incrementCountsOf(ext.getState(0), &listen, &hear, ext.getState(i % 2));
+            ba_state->model()->count(&listen, ext.getState(1), &hear) += .5;
+
+            auto const copy = static_cast<BAPOMDPState*>(ba_state->copy(ext.getState(0)));
+            delete (ba_state);
+            ba_state = copy;
+        }
+
+        auto const model = static_cast<BAPOMDPState const*>(ba_state)->model();
+
+        THEN("the expected probabilities are the normalized counts")
+        {
+            for (auto s = 0; s < ext.domainSize()._S; ++s)
+            {
+                auto const state = IndexState(s);
+
+                auto total = 0.;
+                for (auto new_s = 0; new_s < ext.domainSize()._S; ++new_s)
+                {
+                    auto const new_state = IndexState(new_s);
+                    total += ba_state->model()->count(&state, &listen, &new_state);
+                }
+
+                auto const expectation = model->transitionExpectation(&state, &listen);
+                for (auto new_s = 0; new_s < ext.domainSize()._S; ++new_s)
+                {
+                    auto const new_state = IndexState(new_s);
+                    REQUIRE(
+                        expectation[new_s]
+                        == Approx(
+                            ba_state->model()->count(&state, &listen, &new_state) / total));
+                }
+
+                total = 0;
+                for (auto o = 0; o < ext.domainSize()._O; ++o)
+                {
+                    auto const observation = IndexObservation(o);
+                    total += ba_state->model()->count(&listen, &state, &observation);
+                }
+
+                for (auto o = 0; o < ext.domainSize()._O; ++o)
+                {
+                    auto const observation = IndexObservation(o);
+                    REQUIRE(
+                        model->computeObservationProbability(
+                            &observation, &listen, &state, rnd::sample::Dir::expectedProbability)
+                        == Approx(
+                            ba_state->model()->count(&listen, &state, &observation) / total));
+                }
+            }
+        }
+
+        delete (ba_state);
+    }
+}
+
 SCENARIO("copy bapomdp states", "[bayes-adaptive][flat]")
 {
     GIVEN("A BAPOMDPState copied from another")
@@ -242,6 +319,50 @@ SCENARIO("copy bapomdp states", "[bayes-adaptive][flat]")
     }
 }
 
+SCENARIO("simulating with the counts of a bapomdp state", "[bayes-adaptive][flat]")
+{
+    GIVEN("A simulation state of a BAPOMDPState in the tiger problem")
+    {
+        auto c               = configurations::BAConf();
+        c.domain_conf.domain = "episodic-tiger";
+
+        auto const d   = domains::Tiger(domains::Tiger::TigerType::EPISODIC);
+        auto const ext = bayes_adaptive::domain_extensions::TigerBAExtension(
+            domains::Tiger::TigerType::EPISODIC);
+        auto const p = factory::makeTBAPOMDPPrior(d, c);
+
+        auto const particle = p->sample(ext.getState(0));
+        BASimulationState const sim(particle, ext.getState(1));
+
+        auto const listen = IndexAction(domains::Tiger::OBSERVE);
+        auto const hear   = IndexObservation(0);
+
+        THEN("It has its own domain state, but the model of the particle")
+        {
+            REQUIRE(particle->_domain_state->index() == 0);
+            REQUIRE(sim._domain_state->index() == 1);
+
+            REQUIRE(
+                sim.computeObservationProbability(
+                    &hear, &listen, ext.getState(0), rnd::sample::Dir::expectedProbability)
+                == particle->computeObservationProbability(
+                    &hear, &listen, ext.getState(0), rnd::sample::Dir::expectedProbability));
+        }
+
+        THEN("Its counts can not be updated")
+        {
+            auto sim_copy = sim.copy(ext.getState(0));
+
+            REQUIRE_THROWS(
+                sim_copy->incrementCountsOf(ext.getState(0), &listen, &hear, ext.getState(0)));
+
+            delete (sim_copy);
+        }
+
+        delete (particle);
+    }
+}
+
 SCENARIO("compute BAPOMDP observation probabilitieis", "[bayes-adaptive][flat][domain]")
 {
 
@@ -263,10 +384,12 @@ SCENARIO("compute BAPOMDP observation probabilitieis", "[bayes-adaptive][flat][d
             auto a = d.generateRandomAction(ba_state);
 
             REQUIRE(
-                ba_state->computeObservationProbability(&o, a, s, rnd::sample::Dir::expectedMult)
+                ba_state->computeObservationProbability(
+                    &o, a, s, rnd::sample::Dir::expectedProbability)
                 == 1);
             REQUIRE(
-                ba_state->computeObservationProbability(&o, a, s, rnd::sample::Dir::sampleMult)
+                ba_state->computeObservationProbability(
+                    &o, a, s, rnd::sample::Dir::sampledProbability)
                 == 1);
 
             d.releaseAction(a);
@@ -300,20 +423,20 @@ SCENARIO("compute BAPOMDP observation probabilitieis", "[bayes-adaptive][flat][d
             {
                 REQUIRE(
                     ba_state->computeObservationProbability(
-                        &correct_ob, &listen, s, rnd::sample::Dir::sampleMult)
+                        &correct_ob, &listen, s, rnd::sample::Dir::sampledProbability)
                     == Approx(.85).margin(.01));
                 REQUIRE(
                     ba_state->computeObservationProbability(
-                        &correct_ob, &listen, s, rnd::sample::Dir::expectedMult)
+                        &correct_ob, &listen, s, rnd::sample::Dir::expectedProbability)
                     == Approx(.85).margin(.01));
 
                 REQUIRE(
                     ba_state->computeObservationProbability(
-                        &incorrt_ob, &listen, s, rnd::sample::Dir::sampleMult)
+                        &incorrt_ob, &listen, s, rnd::sample::Dir::sampledProbability)
                     == Approx(.15).margin(.01));
                 REQUIRE(
                     ba_state->computeObservationProbability(
-                        &incorrt_ob, &listen, s, rnd::sample::Dir::expectedMult)
+                        &incorrt_ob, &listen, s, rnd::sample::Dir::expectedProbability)
                     == Approx(.15).margin(.01));
             }
 
@@ -321,20 +444,20 @@ SCENARIO("compute BAPOMDP observation probabilitieis", "[bayes-adaptive][flat][d
             {
                 REQUIRE(
                     ba_state->computeObservationProbability(
-                        &correct_ob, &open_door, s, rnd::sample::Dir::sampleMult)
+                        &correct_ob, &open_door, s, rnd::sample::Dir::sampledProbability)
                     == Approx(.5).margin(.01));
                 REQUIRE(
                     ba_state->computeObservationProbability(
-                        &correct_ob, &open_door, s, rnd::sample::Dir::expectedMult)
+                        &correct_ob, &open_door, s, rnd::sample::Dir::expectedProbability)
                     == Approx(.5).margin(.01));
 
                 REQUIRE(
                     ba_state->computeObservationProbability(
-                        &incorrt_ob, &open_door, s, rnd::sample::Dir::sampleMult)
+                        &incorrt_ob, &open_door, s, rnd::sample::Dir::sampledProbability)
                     == Approx(.5).margin(.01));
                 REQUIRE(
                     ba_state->computeObservationProbability(
-                        &incorrt_ob, &open_door, s, rnd::sample::Dir::expectedMult)
+                        &incorrt_ob, &open_door, s, rnd::sample::Dir::expectedProbability)
                     == Approx(.5).margin(.01));
             }
 
@@ -41,15 +41,15 @@ TEST_CASE("step function", "[bayes-adaptive]")
                 auto sample_method = (m == 0) ? rnd::sample::Dir::sampleFromSampledMult
                                               : rnd::sample::Dir::sampleFromExpectedMult;
 
-                auto compute_mult_method =
-                    (m == 0) ? rnd::sample::Dir::sampleMult : rnd::sample::Dir::expectedMult;
+                auto compute_prob_method = (m == 0) ? rnd::sample::Dir::sampledProbability
+                                                    : rnd::sample::Dir::expectedProbability;
 
                 BAPOMDP d(
                     std::move(domain),
                     std::move(ext),
                     std::move(prior),
                     sample_method,
-                    compute_mult_method);
+                    compute_prob_method);
 
                 auto s               = d.sampleStartState();
                 auto a               = d.generateRandomAction(s);
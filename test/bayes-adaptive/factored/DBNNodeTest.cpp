@@ -297,7 +297,7 @@ SCENARIO("dbn node incrementing", "[bayes-adaptive][factored][dbn]")
                         values[i] = rnd::slowRandomInt(0, parent_sizes[i]);
                     }
 
-                    auto old_count = node.count(values, output);
+                    float const old_count = node.count(values, output);
                     node.increment(values, output);
                     REQUIRE(node.count(values, output) == old_count + 1);
                 }
@@ -305,3 +305,88 @@ SCENARIO("dbn node incrementing", "[bayes-adaptive][factored][dbn]")
         }
     }
 }
+
+SCENARIO("dbn node expectations follow its counts", "[bayes-adaptive][factored][dbn]")
+{
+    auto graph_range = std::vector<int>({2, 3});
+    auto node        = DBNNode(&graph_range, {0, 1}, 3);
+
+    // returns the expected probability of each output computed from the counts
+    auto const expectation_of_counts = [&node](std::vector<int> const& input) {
+        auto counts = std::vector<float>(3);
+        for (auto o = 0; o < 3; ++o) { counts[o] = node.count(input, o); }
+
+        return expectedMult(&counts[0], 3);
+    };
+
+    WHEN("counts are set, added to, and incremented")
+    {
+        node.count({0, 1}, 0) = 2;
+        node.count({0, 1}, 2) += 3.5;
+        node.count({0, 1}, 2) += 1;
+        node.increment({0, 1}, 1, 4);
+        node.count({0, 1}, 0) = 1;
+
+        node.setDirichletDistribution({1, 2}, {1, 1, 8});
+        node.increment({1, 2}, 0);
+
+        THEN("the expectations and probabilities are those of the counts")
+        {
+            for (auto const& input : {std::vector<int>({0, 1}), std::vector<int>({1, 2})})
+            {
+                auto const expectation = expectation_of_counts(input);
+
+                REQUIRE(node.expectation(input) == expectation);
+
+                for (auto o = 0; o < 3; ++o)
+                {
+                    REQUIRE(
+                        node.probability(input, o, expectedProbability)
+                        == Approx(expectation[o]));
+                }
+            }
+
+            REQUIRE(node.probability({0, 1}, 2, expectedProbability) == Approx(4.5 / 9.5));
+            REQUIRE(node.probability({1, 0}, 0, expectedProbability) == 0);
+        }
+
+        AND_WHEN("marginalizing out a parent")
+        {
+            auto const marginalized = node.marginalizeOut({1});
+
+            THEN("the expectations are those of the summed counts")
+            {
+                REQUIRE(marginalized.expectation({1}) == expectation_of_counts({0, 1}));
+
+                REQUIRE(
+                    marginalized.probability({2}, 0, expectedProbability) == Approx(2. / 11));
+            }
+        }
+    }
+}
+
+SCENARIO("marginalizing fractional counts", "[bayes-adaptive][factored][dbn]")
+{
+    auto graph_range = std::vector<int>({64, 64});
+    auto node        = DBNNode(&graph_range, {0, 1}, 2);
+
+    for (auto p0 = 0; p0 < 64; ++p0)
+    {
+        for (auto p1 = 0; p1 < 64; ++p1) { node.setDirichletDistribution({p0, p1}, {.1, 1000.3}); }
+    }
+
+    WHEN("marginalizing out all parents")
+    {
+        auto const marginalized = node.marginalizeOut({});
+        auto const expectation  = marginalized.expectation({});
+
+        THEN("the expectation is a distribution")
+        {
+            REQUIRE(expectation[0] + expectation[1] == Approx(1));
+            REQUIRE(
+                marginalized.probability({}, 0, expectedProbability)
+                    + marginalized.probability({}, 1, expectedProbability)
+                == Approx(1));
+        }
+    }
+}
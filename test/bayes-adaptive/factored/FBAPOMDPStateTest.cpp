@@ -294,18 +294,20 @@ SCENARIO("compute fbapomdp observation probabilities", "[domain][factored][bayes
             auto s = ext.getState(rnd::slowRandomInt(0, ext.domainSize()._S));
 
             REQUIRE(
-                ba_state->computeObservationProbability(&o, &a_up, s, rnd::sample::Dir::sampleMult)
+                ba_state->computeObservationProbability(
+                    &o, &a_up, s, rnd::sample::Dir::sampledProbability)
                 == 1);
             REQUIRE(
                 ba_state->computeObservationProbability(
-                    &o, &a_up, s, rnd::sample::Dir::expectedMult)
+                    &o, &a_up, s, rnd::sample::Dir::expectedProbability)
                 == 1);
             REQUIRE(
-                ba_state->computeObservationProbability(&o, &a_up, s, rnd::sample::Dir::sampleMult)
+                ba_state->computeObservationProbability(
+                    &o, &a_up, s, rnd::sample::Dir::sampledProbability)
                 == 1);
             REQUIRE(
                 ba_state->computeObservationProbability(
-                    &o, &a_up, s, rnd::sample::Dir::expectedMult)
+                    &o, &a_up, s, rnd::sample::Dir::expectedProbability)
                 == 1);
 
             d.releaseState(s);
@@ -339,20 +341,20 @@ SCENARIO("compute fbapomdp observation probabilities", "[domain][factored][bayes
             {
                 REQUIRE(
                     ba_state->computeObservationProbability(
-                        &correct_ob, &listen, s, rnd::sample::Dir::sampleMult)
+                        &correct_ob, &listen, s, rnd::sample::Dir::sampledProbability)
                     == Approx(.85).margin(.01));
                 REQUIRE(
                     ba_state->computeObservationProbability(
-                        &correct_ob, &listen, s, rnd::sample::Dir::expectedMult)
+                        &correct_ob, &listen, s, rnd::sample::Dir::expectedProbability)
                     == Approx(.85).margin(.01));
 
                 REQUIRE(
                     ba_state->computeObservationProbability(
-                        &incorrt_ob, &listen, s, rnd::sample::Dir::sampleMult)
+                        &incorrt_ob, &listen, s, rnd::sample::Dir::sampledProbability)
                     == Approx(.15).margin(.01));
                 REQUIRE(
                     ba_state->computeObservationProbability(
-                        &incorrt_ob, &listen, s, rnd::sample::Dir::expectedMult)
+                        &incorrt_ob, &listen, s, rnd::sample::Dir::expectedProbability)
                     == Approx(.15).margin(.01));
             }
 
@@ -360,20 +362,20 @@ SCENARIO("compute fbapomdp observation probabilities", "[domain][factored][bayes
             {
                 REQUIRE(
                     ba_state->computeObservationProbability(
-                        &correct_ob, &open_door, s, rnd::sample::Dir::sampleMult)
+                        &correct_ob, &open_door, s, rnd::sample::Dir::sampledProbability)
                     == Approx(.5).margin(.01));
                 REQUIRE(
                     ba_state->computeObservationProbability(
-                        &correct_ob, &open_door, s, rnd::sample::Dir::expectedMult)
+                        &correct_ob, &open_door, s, rnd::sample::Dir::expectedProbability)
                     == Approx(.5).margin(.01));
 
                 REQUIRE(
                     ba_state->computeObservationProbability(
-                        &incorrt_ob, &open_door, s, rnd::sample::Dir::sampleMult)
+                        &incorrt_ob, &open_door, s, rnd::sample::Dir::sampledProbability)
                     == Approx(.5).margin(.01));
                 REQUIRE(
                     ba_state->computeObservationProbability(
-                        &incorrt_ob, &open_door, s, rnd::sample::Dir::expectedMult)
+                        &incorrt_ob, &open_door, s, rnd::sample::Dir::expectedProbability)
                     == Approx(.5).margin(.01));
             }
 
@@ -210,6 +210,39 @@ SCENARIO("generating random collision-avoidance actions", "[domain][collision-av
     d.releaseAction(a);
 }
 
+SCENARIO("collision avoidance heuristics", "[domain][collision-avoidance]")
+{
+    auto const d = domains::CollisionAvoidance(4, 5);
+
+    WHEN("The obstacle is in line with the agent")
+    {
+        auto const s = d.getState(1, 2, {2});
+        auto const a = d.generateHeuristicAction(s);
+
+        THEN("The agent moves out of the way")
+        {
+            REQUIRE(a->index() != domains::CollisionAvoidance::STAY);
+            REQUIRE(d.heuristicValue(s, 1) == -2 * domains::CollisionAvoidance::MOVE_PENALTY);
+        }
+
+        d.releaseAction(a);
+    }
+
+    WHEN("The obstacle is far away from the agent")
+    {
+        auto const s = d.getState(1, 0, {4});
+        auto const a = d.generateHeuristicAction(s);
+
+        THEN("The agent stays in its row")
+        {
+            REQUIRE(a->index() == domains::CollisionAvoidance::STAY);
+            REQUIRE(d.heuristicValue(s, 1) == 0);
+        }
+
+        d.releaseAction(a);
+    }
+}
+
 SCENARIO("adding legal actions in the collision avoidance domain", "[domain][collision-avoidance")
 {
     auto const d = domains::CollisionAvoidance(4, 5);
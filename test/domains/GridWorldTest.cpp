@@ -160,6 +160,28 @@ SCENARIO("gridworld POMDP functions", "[domain][gridworld]")
         d.releaseState(s);
     }
 
+    WHEN("Generating heuristic actions for gridworld")
+    {
+        using pos = domains::GridWorld::GridWorldState::pos;
+
+        auto const goal = *d.goalLocation(0);
+        auto const s    = d.getState({0, 0}, goal);
+
+        auto const distance = [goal](pos const& p) { return (goal.x - p.x) + (goal.y - p.y); };
+
+        for (auto i = 0; i < 10; ++i)
+        {
+            auto const a = d.generateHeuristicAction(s);
+
+            REQUIRE(distance(d.applyMove({0, 0}, a)) == distance({0, 0}) - 1);
+
+            d.releaseAction(a);
+        }
+
+        REQUIRE(d.heuristicValue(s, distance({0, 0}) + 1) == d.goalReward());
+        REQUIRE(d.heuristicValue(s, distance({0, 0})) == domains::GridWorld::step_reward);
+    }
+
     WHEN("generating all legal actions for gridworld")
     {
 
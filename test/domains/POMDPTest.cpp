@@ -0,0 +1,266 @@
+#include "catch.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "configurations/DomainConf.hpp"
+#include "domains/ConcreteDomains.hpp"
+#include "domains/POMDP.hpp"
+#include "domains/collision-avoidance/CollisionAvoidance.hpp"
+#include "domains/gridworld/GridWorld.hpp"
+#include "domains/sysadmin/SysAdmin.hpp"
+#include "domains/tiger/FactoredTiger.hpp"
+#include "domains/tiger/Tiger.hpp"
+#include "environment/Action.hpp"
+#include "environment/Observation.hpp"
+#include "environment/Reward.hpp"
+#include "environment/State.hpp"
+#include "environment/Terminal.hpp"
+#include "utils/random.hpp"
+
+namespace {
+
+/**
+ * @brief requires that `stepMany` on the states in `batch` gives the same as `step` on each
+ *
+ * The states are released afterwards
+ **/
+void requireBatchEqualsSteps(POMDP const& d, Action const* a, std::vector<State const*> batch)
+{
+    auto const n = batch.size();
+    auto single  = batch;
+
+    std::vector<int> observations(n);
+    std::vector<double> rewards(n);
+    std::unique_ptr<bool[]> terminals(new bool[n]);
+
+    rnd::seedThread(42);
+    d.stepMany(batch.data(), n, a, observations.data(), rewards.data(), terminals.get());
+
+    rnd::seedThread(42);
+    for (size_t i = 0; i < n; ++i)
+    {
+        Observation const* o(nullptr);
+        Reward r(0);
+
+        auto const t = d.step(&single[i], a, &o, &r);
+
+        REQUIRE(batch[i]->index() == single[i]->index());
+        REQUIRE(observations[i] == o->index());
+        REQUIRE(rewards[i] == Approx(r.toDouble()));
+        REQUIRE(terminals[i] == t.terminated());
+
+        d.releaseObservation(o);
+        d.releaseState(batch[i]);
+        d.releaseState(single[i]);
+    }
+}
+
+/**
+ * @brief requires that `stepMany` on n start states of d gives the same as `step` on each
+ **/
+void requireBatchEqualsSteps(POMDP const& d, Action const* a, size_t n)
+{
+    auto batch = std::vector<State const*>();
+    while (batch.size() < n) { batch.emplace_back(d.sampleStartState()); }
+
+    requireBatchEqualsSteps(d, a, batch);
+}
+
+/**
+ * @brief returns whether it is called with a concrete domain, rather than `POMDP`
+ **/
+struct IsConcrete
+{
+    template<typename Domain>
+    bool operator()(Domain const& /*domain*/) const
+    {
+        return !std::is_same<Domain, POMDP>::value;
+    }
+};
+
+} // namespace
+
+SCENARIO("dispatching to the concrete type of made domains", "[domain][factory]")
+{
+    configurations::DomainConf c;
+
+    c.size   = 3;
+    c.width  = 3;
+    c.height = 3;
+
+    for (auto const& domain :
+         {"dummy",
+          "linear_dummy",
+          "factored-dummy",
+          "episodic-tiger",
+          "continuous-tiger",
+          "agr",
+          "coffee",
+          "boutilier-coffee",
+          "independent-sysadmin",
+          "linear-sysadmin",
+          "episodic-factored-tiger",
+          "continuous-factored-tiger",
+          "gridworld",
+          "random-collision-avoidance",
+          "centered-collision-avoidance"})
+    {
+        c.domain = domain;
+
+        INFO("domain " << c.domain);
+        REQUIRE(factory::withConcreteDomain(*factory::makePOMDP(c), IsConcrete()));
+    }
+}
+
+SCENARIO("stepping a batch of states", "[domain]")
+{
+    auto const n = 50;
+
+    WHEN("stepping the tiger problems")
+    {
+        domains::Tiger const tiger(domains::Tiger::EPISODIC);
+        domains::FactoredTiger const factored_tiger(domains::FactoredTiger::CONTINUOUS, 2);
+
+        THEN("the batch is stepped as with step")
+        {
+            for (auto i = 0; i < 3; ++i)
+            {
+                IndexAction const a(i);
+                requireBatchEqualsSteps(tiger, &a, n);
+                requireBatchEqualsSteps(factored_tiger, &a, n);
+            }
+        }
+    }
+
+    WHEN("stepping the sysadmin problems")
+    {
+        domains::SysAdmin const independent(4, "independent");
+        domains::SysAdmin const linear(4, "linear");
+
+        THEN("the batch is stepped as with step")
+        {
+            for (auto const d : {&independent, &linear})
+            {
+                requireBatchEqualsSteps(*d, d->observeAction(1), n);
+                requireBatchEqualsSteps(*d, d->rebootAction(3), n);
+            }
+        }
+
+        THEN("a batch of all states (with failing neighbours) is stepped as with step")
+        {
+            for (auto const d : {&independent, &linear})
+            {
+                // every configuration of working (1) and failing (0) computers, a few times
+                // over (the domain owns its states, so they can be stepped repeatedly)
+                auto states = std::vector<State const*>();
+                for (auto repeat = 0; repeat < 4; ++repeat)
+                {
+                    for (auto i = 0; i < 16; ++i)
+                    {
+                        states.emplace_back(
+                            d->getState({i & 1, (i >> 1) & 1, (i >> 2) & 1, (i >> 3) & 1}));
+                    }
+                }
+
+                for (auto c = 0; c < 4; ++c)
+                {
+                    requireBatchEqualsSteps(*d, d->observeAction(c), states);
+                    requireBatchEqualsSteps(*d, d->rebootAction(c), states);
+                }
+            }
+        }
+    }
+
+    WHEN("stepping the gridworld problem")
+    {
+        domains::GridWorld const d(5);
+
+        THEN("the batch is stepped as with step")
+        {
+            for (auto i = 0; i < 4; ++i)
+            {
+                domains::GridWorld::GridWorldAction const a(i);
+                requireBatchEqualsSteps(d, &a, n);
+            }
+        }
+
+        THEN("a batch of all states (including those on the goal) is stepped as with step")
+        {
+            // (the domain owns its states, so they can be stepped repeatedly)
+            auto states = std::vector<State const*>();
+            for (unsigned int x = 0; x < 5; ++x)
+            {
+                for (unsigned int y = 0; y < 5; ++y)
+                {
+                    for (auto const& goal : domains::GridWorld::goalLocations(5))
+                    {
+                        states.emplace_back(d.getState({x, y}, goal));
+                    }
+                }
+            }
+
+            for (auto i = 0; i < 4; ++i)
+            {
+                domains::GridWorld::GridWorldAction const a(i);
+                requireBatchEqualsSteps(d, &a, states);
+            }
+        }
+    }
+
+    WHEN("stepping the collision avoidance problem")
+    {
+        domains::CollisionAvoidance const d(5, 5, 2);
+
+        // states close to (and in reach of) the obstacles
+        auto states = std::vector<State const*>();
+        for (auto x = 1; x < 3; ++x)
+        {
+            for (auto y = 0; y < 5; ++y)
+            {
+                for (auto y_obstacle = 0; y_obstacle < 5; ++y_obstacle)
+                {
+                    states.emplace_back(d.getState(x, y, {y_obstacle, y_obstacle}));
+                }
+            }
+        }
+
+        auto const old_states = states;
+
+        std::vector<int> observations(states.size());
+        std::vector<double> rewards(states.size());
+        std::unique_ptr<bool[]> terminals(new bool[states.size()]);
+
+        auto const a = d.getAction(domains::CollisionAvoidance::MOVE_UP);
+        d.stepMany(
+            states.data(), states.size(), a, observations.data(), rewards.data(), terminals.get());
+
+        THEN("every state is stepped legally")
+        {
+            for (size_t i = 0; i < states.size(); ++i)
+            {
+                auto const x       = d.xAgent(states[i]);
+                auto const crashed = x < 2 && d.yAgent(states[i]) == d.yObstacles(states[i])[x];
+
+                REQUIRE(x == d.xAgent(old_states[i]) - 1);
+                REQUIRE(rewards[i] == (crashed ? -1000 : -1));
+                REQUIRE(terminals[i] == (crashed || x == 0));
+                REQUIRE(observations[i] >= 0);
+                REQUIRE(observations[i] < 25);
+            }
+        }
+
+        THEN("the batch of start states is stepped as with step")
+        {
+            for (auto const m : {domains::CollisionAvoidance::MOVE_DOWN,
+                                 domains::CollisionAvoidance::STAY,
+                                 domains::CollisionAvoidance::MOVE_UP})
+            {
+                requireBatchEqualsSteps(d, d.getAction(m), n);
+            }
+        }
+    }
+}
@@ -0,0 +1,162 @@
+#include "catch.hpp"
+
+#include <vector>
+
+#include "beliefs/Belief.hpp"
+#include "beliefs/particle_filters/RejectionSampling.hpp"
+#include "configurations/Conf.hpp"
+#include "domains/dummy/LinearDummyDomain.hpp"
+#include "domains/gridworld/GridWorld.hpp"
+#include "environment/Action.hpp"
+#include "environment/Discount.hpp"
+#include "environment/History.hpp"
+#include "environment/Horizon.hpp"
+#include "environment/State.hpp"
+#include "experiments/Episode.hpp"
+#include "planners/Planner.hpp"
+#include "planners/mcts/POUCT.hpp"
+#include "utils/random.hpp"
+
+namespace {
+
+/**
+ * @brief picks random actions, and records whether the belief matches the history at each step
+ *
+ * For the (deterministic) `LinearDummyDomain`: the only state the belief
+ * may contain is the number of forward minus backward actions in the history.
+ **/
+class BeliefRecorder : public Planner
+{
+public:
+    Action const* selectAction(POMDP const& simulator, Belief const& belief, History const& h)
+        const final
+    {
+        auto expected_state = 0;
+        for (auto const& step : h)
+        {
+            expected_state +=
+                (step.action->index() == domains::LinearDummyDomain::FORWARD) ? 1 : -1;
+        }
+
+        auto matches = true;
+        for (auto i = 0; i < 10; ++i)
+        {
+            matches = matches && belief.sample()->index() == expected_state;
+        }
+
+        matching.emplace_back(matches);
+
+        return simulator.generateRandomAction(belief.sample());
+    }
+
+    // whether the samples of the belief matched the history, per step
+    mutable std::vector<bool> matching = {};
+};
+
+} // namespace
+
+SCENARIO("running pipelined episodes", "[experiment][episode]")
+{
+    domains::GridWorld const env(3);
+    domains::GridWorld const simulator(3);
+
+    configurations::Conf c;
+
+    c.horizon                             = 10;
+    c.planner_conf.mcts_max_depth         = c.horizon;
+    c.planner_conf.mcts_simulation_amount = 256;
+
+    planners::POUCT const planner(c);
+    beliefs::RejectionSampling belief(1000);
+
+    belief.initiate(simulator);
+
+    WHEN("Overlapping the belief updates with planning")
+    {
+        auto const r = episode::runPipelined(
+            planner, belief, env, simulator, Horizon(c.horizon), Discount(c.discount), 8);
+
+        THEN("The episode runs until the horizon or goal")
+        {
+            REQUIRE(r.length > 0);
+            REQUIRE(r.length <= c.horizon);
+            REQUIRE(r.ret.toDouble() >= 0);
+            REQUIRE(r.ret.toDouble() <= 1);
+        }
+    }
+
+    belief.free(simulator);
+}
+
+SCENARIO("comparing pipelined with sequential episodes", "[experiment][episode]")
+{
+    domains::LinearDummyDomain const d;
+
+    auto const h        = Horizon(10);
+    auto const discount = Discount(0.95);
+
+    BeliefRecorder sequential_planner, pipelined_planner;
+    beliefs::RejectionSampling sequential_belief(100), pipelined_belief(100);
+
+    rnd::seedThread(42);
+
+    sequential_belief.initiate(d);
+    auto const sequential = episode::run(sequential_planner, sequential_belief, d, d, h, discount);
+
+    rnd::seedThread(42);
+
+    pipelined_belief.initiate(d);
+    auto const pipelined =
+        episode::runPipelined(pipelined_planner, pipelined_belief, d, d, h, discount, 8);
+
+    THEN("Both episodes run until the horizon with the same return")
+    {
+        REQUIRE(sequential.length == h.toInt());
+        REQUIRE(pipelined.length == sequential.length);
+        REQUIRE(pipelined.ret.toDouble() == Approx(sequential.ret.toDouble()));
+    }
+
+    THEN("The belief planned with matches the history at every step")
+    {
+        REQUIRE(sequential_planner.matching == std::vector<bool>(h.toInt(), true));
+        REQUIRE(pipelined_planner.matching == std::vector<bool>(h.toInt(), true));
+    }
+
+    sequential_belief.free(d);
+    pipelined_belief.free(d);
+}
+
+TEST_CASE("pipelined episode benchmark", "[.benchmark][experiment][episode]")
+{
+    // gridworld with many (rejection sampling) particles, where updates take long
+    domains::GridWorld const d(5);
+
+    configurations::Conf c;
+
+    c.horizon                             = 10;
+    c.planner_conf.mcts_max_depth         = c.horizon;
+    c.planner_conf.mcts_simulation_amount = 4096;
+
+    planners::POUCT const planner(c);
+    beliefs::RejectionSampling belief(100000);
+
+    // reports the time of an episode (including the initiation of the belief)
+    BENCHMARK("episode, sequential belief updates")
+    {
+        belief.initiate(d);
+        auto const r = episode::run(planner, belief, d, d, Horizon(c.horizon), Discount(0.95));
+        belief.free(d);
+
+        return r.length;
+    };
+
+    BENCHMARK("episode, pipelined belief updates")
+    {
+        belief.initiate(d);
+        auto const r = episode::runPipelined(
+            planner, belief, d, d, Horizon(c.horizon), Discount(0.95), 64);
+        belief.free(d);
+
+        return r.length;
+    };
+}
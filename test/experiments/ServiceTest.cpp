@@ -0,0 +1,134 @@
+#include "catch.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#include "beliefs/particle_filters/RejectionSampling.hpp"
+#include "configurations/Conf.hpp"
+#include "domains/tiger/Tiger.hpp"
+#include "environment/Discount.hpp"
+#include "environment/Horizon.hpp"
+#include "experiments/Service.hpp"
+#include "planners/mcts/POUCT.hpp"
+
+SCENARIO("serving tiger episodes", "[experiment][service]")
+{
+    domains::Tiger const env(domains::Tiger::EPISODIC);
+    domains::Tiger const simulator(domains::Tiger::EPISODIC);
+
+    configurations::Conf c;
+
+    c.horizon                             = 3;
+    c.planner_conf.mcts_max_depth         = c.horizon;
+    c.planner_conf.mcts_simulation_amount = 4096;
+    c.planner_conf.mcts_exploration_const = 100;
+
+    int requests[2], replies[2];
+    REQUIRE(::pipe(requests) == 0);
+    REQUIRE(::pipe(replies) == 0);
+
+    WHEN("Serving requests of two sessions with two workers")
+    {
+        std::string const input = "open\nopen\nstep 0\nstep 1\nstep 0\nclose 0\nclose 1\nstep 0\n"
+                                  "bogus\nquit\nopen\n";
+        REQUIRE(::write(requests[1], input.data(), input.size()) == static_cast<int>(input.size()));
+        ::close(requests[1]);
+
+        {
+            experiment::Service service(
+                env,
+                simulator,
+                [&c] { return std::unique_ptr<Planner>(new planners::POUCT(c)); },
+                [] { return std::unique_ptr<Belief>(new beliefs::RejectionSampling(100)); },
+                Horizon(c.horizon),
+                Discount(c.discount),
+                2);
+
+            service.serve(requests[0], replies[1]);
+        }
+
+        ::close(replies[1]);
+
+        // the replies of different sessions may come in any order
+        std::string output;
+        char chunk[1024];
+
+        auto n = ::read(replies[0], chunk, sizeof(chunk));
+        while (n > 0)
+        {
+            output.append(chunk, n);
+            n = ::read(replies[0], chunk, sizeof(chunk));
+        }
+
+        std::vector<std::string> lines;
+        std::istringstream stream(output);
+        for (std::string l; std::getline(stream, l);) { lines.emplace_back(l); }
+
+        auto const count = [&lines](std::string const& prefix) {
+            return std::count_if(lines.begin(), lines.end(), [&prefix](std::string const& l) {
+                return l.compare(0, prefix.size(), prefix) == 0;
+            });
+        };
+
+        THEN("Every request is replied to, up to quit")
+        {
+            REQUIRE(lines.size() == 9);
+
+            REQUIRE(count("0 opened") == 1);
+            REQUIRE(count("1 opened") == 1);
+            REQUIRE(count("0 closed") == 1);
+            REQUIRE(count("1 closed") == 1);
+            REQUIRE(count("error unknown session 0") == 1);
+            REQUIRE(count("error unknown request: bogus") == 1);
+        }
+
+        THEN("The first step of each session listens")
+        {
+            REQUIRE(count("0 2 ") >= 1);
+            REQUIRE(count("1 2 ") == 1);
+        }
+    }
+
+    WHEN("Serving a request that fails with a standard exception")
+    {
+        std::string const input = "open\nquit\n";
+        REQUIRE(::write(requests[1], input.data(), input.size()) == static_cast<int>(input.size()));
+        ::close(requests[1]);
+
+        {
+            experiment::Service service(
+                env,
+                simulator,
+                [&c] { return std::unique_ptr<Planner>(new planners::POUCT(c)); },
+                []() -> std::unique_ptr<Belief> { throw std::runtime_error("no belief"); },
+                Horizon(c.horizon),
+                Discount(c.discount),
+                1);
+
+            service.serve(requests[0], replies[1]);
+        }
+
+        ::close(replies[1]);
+
+        std::string output;
+        char chunk[1024];
+
+        auto n = ::read(replies[0], chunk, sizeof(chunk));
+        while (n > 0)
+        {
+            output.append(chunk, n);
+            n = ::read(replies[0], chunk, sizeof(chunk));
+        }
+
+        THEN("The error is replied to the session") { REQUIRE(output == "0 error no belief\n"); }
+    }
+
+    ::close(requests[0]);
+    ::close(replies[0]);
+}
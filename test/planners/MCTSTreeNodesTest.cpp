@@ -0,0 +1,247 @@
+#include "catch.hpp"
+
+#include <cmath>
+#include <vector>
+
+#include "environment/Action.hpp"
+#include "planners/mcts/MCTSTreeNodes.hpp"
+#include "utils/Arena.hpp"
+
+SCENARIO("selecting actions in an action node with UCB", "[planning][mcts]")
+{
+    auto const num_actions = 5;
+
+    std::vector<IndexAction> actions;
+    for (auto i = 0; i < num_actions; ++i) { actions.emplace_back(i); }
+
+    std::vector<Action const*> legal_actions;
+    for (auto const& a : actions) { legal_actions.emplace_back(&a); }
+
+    utils::Arena arena;
+    auto const n = arena.create<ActionNode>(legal_actions, &arena);
+
+    std::vector<double> scratch;
+
+    GIVEN("A node without visits")
+    {
+        THEN("Any action may be picked")
+        {
+            std::vector<int> picked(num_actions, 0);
+            for (auto i = 0; i < 1000; ++i) { picked[n->selectUCB(1, 0, true, &scratch)]++; }
+
+            for (auto count : picked) { REQUIRE(count > 100); }
+        }
+    }
+
+    GIVEN("A node where all but one action were visited")
+    {
+        for (auto a = 0; a < num_actions; ++a)
+        {
+            if (a != 2)
+            {
+                n->addVisit(a, 10);
+                n->addVisit();
+            }
+        }
+
+        THEN("Exploring picks the unvisited action")
+        {
+            REQUIRE(n->selectUCB(1, std::log1p(n->visited()), true, &scratch) == 2);
+        }
+
+        THEN("Without exploration the unvisited action is worst")
+        {
+            REQUIRE(n->selectUCB(1, std::log1p(n->visited()), false, &scratch) != 2);
+        }
+    }
+
+    GIVEN("A node with different q values")
+    {
+        for (auto a = 0; a < num_actions; ++a)
+        {
+            n->addVisit(a, a);
+            n->addVisit();
+        }
+
+        THEN("The action with the highest q value is picked")
+        {
+            REQUIRE(n->selectUCB(1, std::log1p(n->visited()), false, &scratch) == 4);
+            REQUIRE(n->selectUCB(0, std::log1p(n->visited()), true, &scratch) == 4);
+        }
+
+        THEN("A large exploration constant prefers the less visited actions")
+        {
+            for (auto i = 0; i < 10; ++i) { n->addVisit(4, 4); }
+
+            REQUIRE(n->selectUCB(100, std::log1p(n->visited()), true, &scratch) != 4);
+        }
+
+        THEN("Virtual loss makes actions less attractive")
+        {
+            n->addVirtualLoss(4);
+
+            REQUIRE(n->selectUCB(1, std::log1p(n->visited()), false, &scratch) == 3);
+
+            n->removeVirtualLoss(4);
+
+            REQUIRE(n->selectUCB(1, std::log1p(n->visited()), false, &scratch) == 4);
+        }
+
+        THEN("The most visited action is picked regardless of its q value")
+        {
+            for (auto i = 0; i < 3; ++i) { n->addVisit(1, 0); }
+
+            REQUIRE(n->mostVisited() == 1);
+        }
+
+        THEN("Ties in visits are broken randomly")
+        {
+            n->addVisit(1, 0);
+            n->addVisit(3, 0);
+
+            std::vector<int> picked(num_actions, 0);
+            for (auto i = 0; i < 1000; ++i) { picked[n->mostVisited()]++; }
+
+            REQUIRE(picked[1] > 400);
+            REQUIRE(picked[3] > 400);
+            REQUIRE(picked[1] + picked[3] == 1000);
+        }
+    }
+
+    n->~ActionNode();
+}
+
+SCENARIO("sampling children of a chance node", "[planning][mcts]")
+{
+    IndexAction const action(0);
+    std::vector<Action const*> const legal_actions({&action});
+
+    utils::Arena arena;
+    auto const parent = arena.create<ActionNode>(legal_actions, &arena);
+    auto const rare   = arena.create<ActionNode>(legal_actions, &arena);
+    auto const common = arena.create<ActionNode>(legal_actions, &arena);
+
+    for (auto i = 0; i < 19; ++i) { common->addVisit(); }
+
+    auto& chance_node = parent->chanceNode(0);
+    chance_node.addChild(3, rare, &arena);
+    chance_node.addChild(7, common, &arena);
+
+    GIVEN("Two children, one visited much more often")
+    {
+        THEN("Both are sampled, proportionally to their visits")
+        {
+            auto num_common = 0;
+            for (auto i = 0; i < 1000; ++i)
+            {
+                auto const child = chance_node.sampleChild();
+
+                REQUIRE((child == rare || child == common));
+                num_common += static_cast<int>(child == common);
+            }
+
+            REQUIRE(chance_node.numChildren() == 2);
+            REQUIRE(num_common > 900);
+            REQUIRE(num_common < 1000);
+        }
+    }
+
+    common->~ActionNode();
+    rare->~ActionNode();
+    parent->~ActionNode();
+}
+
+SCENARIO("adding children to a chance node", "[planning][mcts]")
+{
+    IndexAction const action(0);
+    std::vector<Action const*> const legal_actions({&action});
+
+    utils::Arena arena;
+    auto const parent = arena.create<ActionNode>(legal_actions, &arena);
+    auto& chance_node = parent->chanceNode(0);
+
+    std::vector<ActionNode*> children;
+    for (auto i = 0; i < 8; ++i)
+    {
+        children.emplace_back(arena.create<ActionNode>(legal_actions, &arena));
+    }
+
+    GIVEN("A new chance node")
+    {
+        THEN("It is compact and has no children")
+        {
+            REQUIRE(sizeof(ChanceNode) <= 16);
+            REQUIRE(chance_node.numChildren() == 0);
+            REQUIRE(!chance_node.hasChild(0));
+            REQUIRE(chance_node.begin() == chance_node.end());
+            REQUIRE(chance_node._action == &action);
+        }
+    }
+
+    GIVEN("More children than are stored inline")
+    {
+        for (auto i = 0; i < 8; ++i) { chance_node.addChild(2 * i, children[i], &arena); }
+
+        // already present, ignored
+        chance_node.addChild(0, children[1], &arena);
+
+        THEN("All are found by their observation")
+        {
+            REQUIRE(chance_node.numChildren() == 8);
+
+            for (auto i = 0; i < 8; ++i)
+            {
+                REQUIRE(chance_node.hasChild(2 * i));
+                REQUIRE(!chance_node.hasChild(2 * i + 1));
+                REQUIRE(chance_node.child(2 * i) == children[i]);
+            }
+
+            auto num_iterated = 0;
+            for (auto const& c : chance_node)
+            {
+                REQUIRE(c.second == children[c.first / 2]);
+                num_iterated++;
+            }
+
+            REQUIRE(num_iterated == 8);
+        }
+    }
+
+    for (auto c : children) { c->~ActionNode(); }
+    parent->~ActionNode();
+}
+
+TEST_CASE("ucb action selection benchmark", "[.benchmark][planning][mcts]")
+{
+    // comparable to wide action spaces (e.g. sys admin with many computers)
+    for (auto num_actions : {4, 32, 256})
+    {
+        std::vector<IndexAction> actions;
+        for (auto i = 0; i < num_actions; ++i) { actions.emplace_back(i); }
+
+        std::vector<Action const*> legal_actions;
+        for (auto const& a : actions) { legal_actions.emplace_back(&a); }
+
+        utils::Arena arena;
+        auto const n = arena.create<ActionNode>(legal_actions, &arena);
+
+        for (auto a = 0; a < num_actions; ++a)
+        {
+            for (auto i = 0; i <= a % 7; ++i)
+            {
+                n->addVisit(a, (a * 13) % 17);
+                n->addVisit();
+            }
+        }
+
+        std::vector<double> scratch;
+        auto const log_m = std::log1p(n->visited());
+
+        BENCHMARK("select UCB, " + std::to_string(num_actions) + " actions")
+        {
+            return n->selectUCB(10, log_m, true, &scratch);
+        };
+
+        n->~ActionNode();
+    }
+}
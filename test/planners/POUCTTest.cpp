@@ -0,0 +1,378 @@
+#include "catch.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "beliefs/particle_filters/RejectionSampling.hpp"
+#include "configurations/Conf.hpp"
+#include "domains/tiger/Tiger.hpp"
+#include "environment/Action.hpp"
+#include "environment/History.hpp"
+#include "environment/Observation.hpp"
+#include "environment/Reward.hpp"
+#include "environment/State.hpp"
+#include "planners/Telemetry.hpp"
+#include "planners/mcts/MCTS.hpp"
+#include "planners/mcts/MCTSTreeNodes.hpp"
+#include "planners/mcts/POUCT.hpp"
+#include "utils/Arena.hpp"
+
+SCENARIO("po-uct on the tiger problem", "[planning][po-uct]")
+{
+    auto const d = domains::Tiger(domains::Tiger::EPISODIC);
+    auto b       = beliefs::RejectionSampling(100);
+
+    b.initiate(d);
+
+    configurations::Conf c;
+
+    c.horizon                             = 3;
+    c.planner_conf.mcts_max_depth         = c.horizon;
+    c.planner_conf.mcts_simulation_amount = 4096;
+    c.planner_conf.mcts_exploration_const = 100;
+
+    History const h;
+
+    GIVEN("An uninformed belief")
+    {
+        WHEN("Planning with a single thread")
+        {
+            planners::POUCT const p(c);
+            auto const a = p.selectAction(d, b, h);
+
+            THEN("The planner should listen") { REQUIRE(a->index() == domains::Tiger::OBSERVE); }
+
+            d.releaseAction(a);
+        }
+
+        WHEN("Planning with multiple (root-parallel) threads")
+        {
+            c.planner_conf.mcts_threads = 4;
+
+            planners::POUCT const p(c);
+            auto const a = p.selectAction(d, b, h);
+
+            THEN("The planner should still listen")
+            {
+                REQUIRE(a->index() == domains::Tiger::OBSERVE);
+            }
+
+            d.releaseAction(a);
+        }
+
+        WHEN("Planning with multiple threads in the same tree")
+        {
+            c.planner_conf.mcts_threads         = 4;
+            c.planner_conf.mcts_parallelization = "tree";
+
+            planners::POUCT const p(c);
+            auto const a = p.selectAction(d, b, h);
+
+            THEN("The planner should still listen")
+            {
+                REQUIRE(a->index() == domains::Tiger::OBSERVE);
+            }
+
+            d.releaseAction(a);
+        }
+
+        WHEN("Planning until a deadline")
+        {
+            c.planner_conf.mcts_time_ms = 50;
+
+            planners::POUCT const p(c);
+
+            auto const start = std::chrono::steady_clock::now();
+            auto const a     = p.selectAction(d, b, h);
+            auto const spent = std::chrono::steady_clock::now() - start;
+
+            THEN("The planner uses its time and should listen")
+            {
+                REQUIRE(spent >= std::chrono::milliseconds(50));
+                REQUIRE(spent < std::chrono::seconds(5));
+                REQUIRE(a->index() == domains::Tiger::OBSERVE);
+            }
+
+            d.releaseAction(a);
+        }
+
+        WHEN("Planning twice while re-using the tree")
+        {
+            std::stringstream records;
+            planners::TelemetrySink sink(records, planners::TelemetrySink::JSONL);
+
+            c.planner_conf.mcts_reuse_tree = true;
+
+            planners::POUCT p(c);
+            p.telemetry(&sink);
+
+            auto const a = p.selectAction(d, b, h);
+
+            // listen in the real environment
+            auto s = d.sampleStartState();
+            Observation const* o;
+            Reward r(0);
+            d.step(&s, a, &o, &r);
+
+            b.updateEstimation(a, o, d);
+
+            // the value of `key` in the last record
+            auto const value = [&records](std::string const& key) {
+                auto const record = records.str().substr(records.str().rfind("{"));
+                auto const start  = record.find("\"" + key + "\": ") + key.size() + 4;
+                return std::stoi(record.substr(start, record.find_first_of(",}", start) - start));
+            };
+
+            THEN("The planner continues from the sub tree of the real action and observation")
+            {
+                History h_next;
+                h_next.add(a, o);
+
+                auto const next_a = p.selectAction(d, b, h_next);
+
+                REQUIRE(value("simulations_reused") > 0);
+                REQUIRE(value("simulations_reused") < 4096);
+
+                d.releaseAction(next_a);
+            }
+
+            THEN("The planner starts over when the history does not follow the previous call")
+            {
+                IndexAction const other_a((a->index() + 1) % 3);
+
+                History h_other;
+                h_other.add(&other_a, o);
+
+                auto const next_a = p.selectAction(d, b, h_other);
+
+                REQUIRE(value("simulations_reused") == 0);
+
+                d.releaseAction(next_a);
+            }
+
+            d.releaseObservation(o);
+            d.releaseState(s);
+            d.releaseAction(a);
+        }
+
+        WHEN("Planning with observation progressive widening")
+        {
+            // at most a single observation per chance node
+            c.planner_conf.mcts_pw_k     = 1;
+            c.planner_conf.mcts_pw_alpha = 0;
+
+            planners::POUCT const p(c);
+            auto const a = p.selectAction(d, b, h);
+
+            THEN("The planner cannot tell the observations apart, so should keep listening")
+            {
+                REQUIRE(a->index() == domains::Tiger::OBSERVE);
+            }
+
+            d.releaseAction(a);
+        }
+
+        WHEN("Planning with truncated rollouts")
+        {
+            std::stringstream records;
+            planners::TelemetrySink sink(records, planners::TelemetrySink::JSONL);
+
+            c.planner_conf.mcts_rollout       = "truncated";
+            c.planner_conf.mcts_rollout_depth = 1;
+
+            planners::POUCT p(c);
+            p.telemetry(&sink);
+
+            auto const a = p.selectAction(d, b, h);
+
+            THEN("Rollouts stop after their depth, and the planner should still listen")
+            {
+                auto const record = records.str();
+
+                auto const value = [&record](std::string const& key) {
+                    auto const start = record.find("\"" + key + "\": ") + key.size() + 4;
+                    return std::stoi(record.substr(start, record.find(',', start) - start));
+                };
+
+                REQUIRE(value("rollout_steps") > 0);
+                REQUIRE(
+                    value("rollout_steps")
+                    <= value("simulations") * c.planner_conf.mcts_rollout_depth);
+                REQUIRE(a->index() == domains::Tiger::OBSERVE);
+            }
+
+            d.releaseAction(a);
+        }
+
+        WHEN("Planning with a transposition table")
+        {
+            std::stringstream records;
+            planners::TelemetrySink sink(records, planners::TelemetrySink::JSONL);
+
+            c.planner_conf.mcts_transposition_size  = 1024;
+            c.planner_conf.mcts_transposition_steps = 1;
+
+            planners::POUCT p(c);
+            p.telemetry(&sink);
+
+            auto const a = p.selectAction(d, b, h);
+
+            THEN("Nodes are shared through the table, and the planner should still listen")
+            {
+                auto const record = records.str();
+                auto const start  = record.find("\"transpositions\": ") + 18;
+
+                REQUIRE(std::stoi(record.substr(start, record.find('}', start) - start)) > 0);
+                REQUIRE(a->index() == domains::Tiger::OBSERVE);
+            }
+
+            d.releaseAction(a);
+        }
+
+        WHEN("Planning with a limited number of nodes or bytes")
+        {
+            std::stringstream records;
+            planners::TelemetrySink sink(records, planners::TelemetrySink::CSV);
+
+            auto const max_bytes = 16 * ActionNode::bytes(3);
+
+            c.planner_conf.mcts_max_nodes = 8;
+            planners::POUCT p_nodes(c);
+            p_nodes.telemetry(&sink);
+
+            c.planner_conf.mcts_max_nodes = 0;
+            c.planner_conf.mcts_max_bytes = static_cast<long>(max_bytes);
+            planners::POUCT p_bytes(c);
+            p_bytes.telemetry(&sink);
+
+            auto const a_nodes = p_nodes.selectAction(d, b, h);
+            auto const a_bytes = p_bytes.selectAction(d, b, h);
+
+            THEN("The tree stops growing at the limit, but the planner still listens")
+            {
+                std::string header, nodes_record, bytes_record;
+                std::getline(records, header);
+                std::getline(records, nodes_record);
+                std::getline(records, bytes_record);
+
+                // planner,simulations,seconds,simulations_per_second,nodes,peak_tree_bytes,...
+                auto const field = [](std::string const& record, int i) {
+                    std::stringstream fields(record);
+                    std::string f;
+                    for (auto j = 0; j <= i; ++j) { std::getline(fields, f, ','); }
+                    return std::stol(f);
+                };
+
+                REQUIRE(field(nodes_record, 1) == 4096);
+                REQUIRE(field(nodes_record, 4) == 8);
+                REQUIRE(field(bytes_record, 1) == 4096);
+                REQUIRE(field(bytes_record, 5) <= static_cast<long>(max_bytes));
+
+                REQUIRE(a_nodes->index() == domains::Tiger::OBSERVE);
+                REQUIRE(a_bytes->index() == domains::Tiger::OBSERVE);
+            }
+
+            d.releaseAction(a_nodes);
+            d.releaseAction(a_bytes);
+        }
+
+        WHEN("Planning with early stopping")
+        {
+            std::stringstream records;
+            planners::TelemetrySink sink(records, planners::TelemetrySink::JSONL);
+
+            c.planner_conf.mcts_early_stop_interval = 64;
+
+            planners::POUCT p(c);
+            p.telemetry(&sink);
+
+            auto const a = p.selectAction(d, b, h);
+
+            THEN("The planner stops once listening is settled, and reports the saved simulations")
+            {
+                auto const record = records.str();
+
+                auto const value = [&record](std::string const& key) {
+                    auto const start = record.find("\"" + key + "\": ") + key.size() + 4;
+                    return std::stoi(record.substr(start, record.find(',', start) - start));
+                };
+
+                REQUIRE(value("simulations") < 4096);
+                REQUIRE(value("simulations") % 64 == 0);
+                REQUIRE(value("simulations") + value("simulations_saved") == 4096);
+
+                REQUIRE(a->index() == domains::Tiger::OBSERVE);
+            }
+
+            d.releaseAction(a);
+        }
+
+        WHEN("Planning while reporting telemetry")
+        {
+            std::stringstream records;
+            planners::TelemetrySink sink(records, planners::TelemetrySink::CSV);
+
+            planners::POUCT p(c);
+            p.telemetry(&sink);
+
+            auto const a = p.selectAction(d, b, h);
+
+            THEN("A header and a record of the search are written")
+            {
+                std::string header, record;
+                std::getline(records, header);
+                std::getline(records, record);
+
+                REQUIRE(header.find("simulations_per_second") != std::string::npos);
+                REQUIRE(record.find("POUCT,4096,") == 0);
+            }
+
+            d.releaseAction(a);
+        }
+
+        WHEN("Planning with an unknown rollout policy")
+        {
+            c.planner_conf.mcts_rollout = "optimal";
+
+            THEN("The planner cannot be created") { REQUIRE_THROWS(planners::POUCT(c)); }
+        }
+
+        WHEN("Creating a planner with a large simulation budget")
+        {
+            c.planner_conf.mcts_simulation_amount = 1 << 20;
+
+            planners::MCTS const mcts(c, "POUCT");
+
+            IndexAction const listen(domains::Tiger::OBSERVE), open(domains::Tiger::LEFT);
+
+            utils::Arena arena;
+            auto const node = arena.create<ActionNode>(
+                std::vector<Action const*>({&listen, &open}), &arena);
+
+            std::vector<double> scratch;
+
+            THEN("Its exploration bonus is u * sqrt(log(1 + m) / n), within and beyond the budget")
+            {
+                auto const u = c.planner_conf.mcts_exploration_const;
+
+                // (the q value of the first child stays 0, so its value is its bonus)
+                for (auto const n : {1, 3, 10})
+                {
+                    while (node->visited(0) < n) { node->addVisit(0, 0); }
+
+                    for (auto const m : {1, 100, (1 << 20) - 1, 1 << 20, 1 << 24})
+                    {
+                        node->selectUCB(u, mcts.logVisits(m), true, &scratch);
+
+                        REQUIRE(scratch[0] == Approx(u * std::sqrt(std::log1p(m) / n)));
+                    }
+                }
+            }
+        }
+    }
+
+    b.free(d);
+}
@@ -0,0 +1,101 @@
+#include "catch.hpp"
+
+#include <utility>
+#include <vector>
+
+#include "environment/Action.hpp"
+#include "planners/mcts/MCTSTreeNodes.hpp"
+#include "planners/mcts/TranspositionTable.hpp"
+#include "utils/Arena.hpp"
+
+SCENARIO("transposition table keys", "[planning][mcts]")
+{
+    using planners::TranspositionTable;
+
+    std::vector<std::pair<int, int>> const path({{0, 1}, {2, 3}, {4, 5}});
+    std::vector<std::pair<int, int>> const other_start({{1, 1}, {2, 3}, {4, 5}});
+    std::vector<std::pair<int, int>> const other_order({{0, 1}, {4, 5}, {2, 3}});
+
+    GIVEN("Paths that share their last steps")
+    {
+        THEN("They are the same node when looking at those steps only")
+        {
+            REQUIRE(
+                TranspositionTable::key(path, 2, 3) == TranspositionTable::key(other_start, 2, 3));
+            REQUIRE(
+                TranspositionTable::key(path, 3, 3) != TranspositionTable::key(other_start, 3, 3));
+        }
+
+        THEN("They are different nodes at different depths")
+        {
+            REQUIRE(
+                TranspositionTable::key(path, 2, 3) != TranspositionTable::key(other_start, 2, 4));
+        }
+    }
+
+    GIVEN("Paths with the same steps in a different order")
+    {
+        THEN("They are different nodes")
+        {
+            REQUIRE(
+                TranspositionTable::key(path, 2, 3) != TranspositionTable::key(other_order, 2, 3));
+        }
+    }
+}
+
+SCENARIO("storing nodes in a transposition table", "[planning][mcts]")
+{
+    IndexAction const action(0);
+    std::vector<Action const*> const legal_actions({&action});
+
+    utils::Arena arena;
+    std::vector<ActionNode*> nodes;
+    for (auto i = 0; i < 3; ++i)
+    {
+        nodes.emplace_back(arena.create<ActionNode>(legal_actions, &arena));
+    }
+
+    GIVEN("A table without entries")
+    {
+        planners::TranspositionTable t;
+        t.insert(1, nodes[0]);
+
+        THEN("Nothing is stored") { REQUIRE(t.find(1) == nullptr); }
+    }
+
+    GIVEN("A table with a single bucket")
+    {
+        planners::TranspositionTable t(2);
+
+        t.insert(1, nodes[0]);
+        t.insert(2, nodes[1]);
+
+        nodes[0]->addVisit();
+
+        THEN("Stored nodes are found by their key")
+        {
+            REQUIRE(t.find(1) == nodes[0]);
+            REQUIRE(t.find(2) == nodes[1]);
+            REQUIRE(t.find(3) == nullptr);
+        }
+
+        THEN("A new node replaces the least visited node")
+        {
+            t.insert(3, nodes[2]);
+
+            REQUIRE(t.find(1) == nodes[0]);
+            REQUIRE(t.find(2) == nullptr);
+            REQUIRE(t.find(3) == nodes[2]);
+        }
+
+        THEN("Clearing removes all nodes")
+        {
+            t.clear();
+
+            REQUIRE(t.find(1) == nullptr);
+            REQUIRE(t.find(2) == nullptr);
+        }
+    }
+
+    for (auto n : nodes) { n->~ActionNode(); }
+}
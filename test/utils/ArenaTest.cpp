@@ -0,0 +1,63 @@
+#include "catch.hpp"
+
+#include <cstdint>
+
+#include "utils/Arena.hpp"
+
+TEST_CASE("arena allocation", "[utils][arena]")
+{
+    auto arena = utils::Arena(128);
+
+    REQUIRE(arena.bytesAllocated() == 0);
+    REQUIRE(arena.capacity() == 0);
+
+    WHEN("allocating objects")
+    {
+        auto const i = arena.create<int>(3);
+        auto const d = arena.create<double>(2.5);
+
+        THEN("they are constructed, aligned and counted")
+        {
+            REQUIRE(*i == 3);
+            REQUIRE(*d == 2.5);
+
+            REQUIRE(reinterpret_cast<std::uintptr_t>(d) % alignof(double) == 0);
+            REQUIRE(arena.bytesAllocated() == sizeof(int) + sizeof(double));
+            REQUIRE(arena.capacity() == 128);
+        }
+    }
+
+    WHEN("allocating more than a block")
+    {
+        auto const small = arena.allocateArray<char>(100);
+        auto const large = arena.allocateArray<double>(100);
+
+        large[99] = 1;
+        small[99] = 'a';
+
+        THEN("new blocks are allocated")
+        {
+            REQUIRE(arena.capacity() > 128 + 100 * sizeof(double));
+            REQUIRE(arena.bytesAllocated() == 100 + 100 * sizeof(double));
+        }
+    }
+
+    WHEN("resetting the arena")
+    {
+        auto const first = arena.create<int>(1);
+        arena.allocateArray<char>(500);
+
+        auto const capacity = arena.capacity();
+
+        arena.reset();
+
+        THEN("the memory is re-used")
+        {
+            REQUIRE(arena.bytesAllocated() == 0);
+            REQUIRE(arena.create<int>(2) == first);
+
+            arena.allocateArray<char>(500);
+            REQUIRE(arena.capacity() == capacity);
+        }
+    }
+}
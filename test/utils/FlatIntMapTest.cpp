@@ -0,0 +1,200 @@
+#include "catch.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <iostream>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "utils/FlatIntMap.hpp"
+#include "utils/random.hpp"
+
+namespace {
+
+/**
+ * @brief std allocator that keeps track of how many bytes are allocated
+ **/
+template<typename T>
+struct CountingAllocator
+{
+    using value_type = T;
+
+    explicit CountingAllocator(size_t* bytes) : _bytes(bytes) {}
+
+    template<typename U>
+    explicit CountingAllocator(CountingAllocator<U> const& other) : _bytes(other._bytes)
+    {
+    }
+
+    T* allocate(size_t n)
+    {
+        *_bytes += n * sizeof(T);
+        return std::allocator<T>().allocate(n);
+    }
+
+    void deallocate(T* p, size_t n)
+    {
+        *_bytes -= n * sizeof(T);
+        std::allocator<T>().deallocate(p, n);
+    }
+
+    bool operator==(CountingAllocator const& other) const { return _bytes == other._bytes; }
+    bool operator!=(CountingAllocator const& other) const { return _bytes != other._bytes; }
+
+    size_t* _bytes;
+};
+
+using CountedUnorderedMap = std::unordered_map<
+    int,
+    int*,
+    std::hash<int>,
+    std::equal_to<int>,
+    CountingAllocator<std::pair<int const, int*>>>;
+
+} // namespace
+
+TEST_CASE("flat int map", "[utils][flat int map]")
+{
+    utils::FlatIntMap<int, 4> m;
+
+    REQUIRE(m.empty());
+    REQUIRE(m.find(0) == nullptr);
+    REQUIRE(m.begin() == m.end());
+
+    WHEN("inserting a few elements")
+    {
+        REQUIRE(m.insert(5, 50));
+        REQUIRE(m.insert(1, 10));
+        REQUIRE(m.insert(3, 30));
+        REQUIRE(!m.insert(3, 300));
+
+        THEN("they can be found without allocating")
+        {
+            REQUIRE(m.size() == 3);
+            REQUIRE(m.heapBytes() == 0);
+
+            REQUIRE(*m.find(1) == 10);
+            REQUIRE(*m.find(3) == 30);
+            REQUIRE(*m.find(5) == 50);
+            REQUIRE(!m.contains(0));
+            REQUIRE(!m.contains(4));
+            REQUIRE(!m.contains(6));
+        }
+
+        THEN("iterating visits them (sorted)")
+        {
+            std::vector<int> keys;
+            for (auto const& e : m) { keys.emplace_back(e.first); }
+
+            REQUIRE(keys == std::vector<int>({1, 3, 5}));
+        }
+    }
+
+    WHEN("inserting more than fit inline")
+    {
+        for (auto i = 0; i < 100; ++i) { REQUIRE(m.insert(i * 7, i)); }
+
+        REQUIRE(!m.insert(14, -1));
+
+        THEN("they are spilled into the hash table")
+        {
+            REQUIRE(m.size() == 100);
+            REQUIRE(m.heapBytes() > 0);
+
+            for (auto i = 0; i < 100; ++i)
+            {
+                REQUIRE(*m.find(i * 7) == i);
+                REQUIRE(!m.contains(i * 7 + 1));
+            }
+        }
+
+        THEN("iterating visits all of them")
+        {
+            std::vector<int> values;
+            for (auto const& e : m) { values.emplace_back(e.second); }
+
+            std::sort(values.begin(), values.end());
+
+            REQUIRE(values.size() == 100);
+            for (auto i = 0; i < 100; ++i) { REQUIRE(values[i] == i); }
+        }
+    }
+
+    WHEN("inserting one element after another")
+    {
+        THEN("the heap grows exactly as predicted before each insertion")
+        {
+            for (auto i = 0; i < 100; ++i)
+            {
+                auto const predicted = m.insertionHeapBytes();
+                auto const before    = m.heapBytes();
+
+                REQUIRE(m.insert(i, i));
+                REQUIRE(m.heapBytes() == before + predicted);
+            }
+
+            REQUIRE(m.heapBytes() > 0);
+        }
+    }
+}
+
+TEST_CASE("flat int map benchmark", "[.benchmark][utils][flat int map]")
+{
+    // comparable to a tree with this many chance nodes
+    auto const num_maps = 10000;
+
+    for (auto num_observations : {2, 4, 8, 32})
+    {
+        size_t unordered_map_bytes = 0;
+
+        std::vector<CountedUnorderedMap> unordered_maps;
+        std::vector<utils::FlatIntMap<int*, 4>> flat_maps(num_maps);
+
+        unordered_maps.reserve(num_maps);
+        for (auto i = 0; i < num_maps; ++i)
+        {
+            unordered_maps.emplace_back(
+                0,
+                std::hash<int>(),
+                std::equal_to<int>(),
+                CountingAllocator<std::pair<int const, int*>>(&unordered_map_bytes));
+
+            for (auto o = 0; o < num_observations; ++o)
+            {
+                unordered_maps.back().insert({o, nullptr});
+                flat_maps[i].insert(o, nullptr);
+            }
+        }
+
+        size_t flat_map_bytes = 0;
+        for (auto const& m : flat_maps) { flat_map_bytes += m.heapBytes(); }
+
+        std::cout << num_observations << " observations, bytes per node: unordered_map "
+                  << sizeof(CountedUnorderedMap) + unordered_map_bytes / num_maps << ", flat map "
+                  << sizeof(utils::FlatIntMap<int*, 4>) + flat_map_bytes / num_maps << "\n";
+
+        // look up (mostly existing) observations in random nodes
+        std::vector<std::pair<int, int>> queries(1000);
+        for (auto& q : queries)
+        {
+            q = {rnd::slowRandomInt(0, num_maps), rnd::slowRandomInt(0, num_observations + 1)};
+        }
+
+        auto const description = std::to_string(num_observations) + " observations";
+
+        BENCHMARK("unordered_map look up, " + description)
+        {
+            auto found = 0;
+            for (auto const& q : queries) { found += unordered_maps[q.first].count(q.second); }
+            return found;
+        };
+
+        BENCHMARK("flat map look up, " + description)
+        {
+            auto found = 0;
+            for (auto const& q : queries) { found += flat_maps[q.first].contains(q.second); }
+            return found;
+        };
+    }
+}
@@ -1,5 +1,9 @@
 #include "catch.hpp"
 
+#include <cmath>
+#include <cstdint>
+#include <future>
+#include <random>
 #include <vector>
 
 #include "utils/random.hpp"
@@ -45,8 +49,9 @@ TEST_CASE("random", "[utils][random]")
                 std::vector<float> counts(size);
                 counts[i] = (float)i + 1;
 
-                REQUIRE(rnd::sample::Dir::sampleFromSampledMult(&counts[0], size) == i);
-                REQUIRE(rnd::sample::Dir::sampleFromExpectedMult(&counts[0], size) == i);
+                auto const total = rnd::sample::Dir::dirichletTotal(&counts[0], size);
+                REQUIRE(rnd::sample::Dir::sampleFromSampledMult(&counts[0], size, total) == i);
+                REQUIRE(rnd::sample::Dir::sampleFromExpectedMult(&counts[0], size, total) == i);
             }
         }
     }
@@ -66,10 +71,11 @@ TEST_CASE("random", "[utils][random]")
                     }
                 }
 
-                REQUIRE(rnd::sample::Dir::sampleFromSampledMult(&counts[0], size) != i);
-                REQUIRE(rnd::sample::Dir::sampleFromExpectedMult(&counts[0], size) != i);
-                REQUIRE(rnd::sample::Dir::sampleFromSampledMult(&counts[0], size) < size);
-                REQUIRE(rnd::sample::Dir::sampleFromExpectedMult(&counts[0], size) < size);
+                auto const total = rnd::sample::Dir::dirichletTotal(&counts[0], size);
+                REQUIRE(rnd::sample::Dir::sampleFromSampledMult(&counts[0], size, total) != i);
+                REQUIRE(rnd::sample::Dir::sampleFromExpectedMult(&counts[0], size, total) != i);
+                REQUIRE(rnd::sample::Dir::sampleFromSampledMult(&counts[0], size, total) < size);
+                REQUIRE(rnd::sample::Dir::sampleFromExpectedMult(&counts[0], size, total) < size);
             }
         }
     }
@@ -84,8 +90,10 @@ TEST_CASE("random", "[utils][random]")
 
             counts[i] = 50000;
 
-            REQUIRE(rnd::sample::Dir::sampleFromSampledMult(&counts[0], size) == i);
-            REQUIRE(rnd::sample::Dir::sampleFromExpectedMult(&counts[0], size) == i);
+            auto const total = rnd::sample::Dir::dirichletTotal(&counts[0], size);
+
+            REQUIRE(rnd::sample::Dir::sampleFromSampledMult(&counts[0], size, total) == i);
+            REQUIRE(rnd::sample::Dir::sampleFromExpectedMult(&counts[0], size, total) == i);
         }
     }
 
@@ -140,6 +148,41 @@ TEST_CASE("random", "[utils][random]")
             for (auto& j : mult) { REQUIRE(i == Approx(j).epsilon(0.001)); }
         }
     }
+
+    WHEN("computing multinomials into buffers, or the probability of a single category")
+    {
+        auto const dir = std::vector<float>({1, 2, 3, 4, 5});
+        auto const n   = static_cast<int>(dir.size());
+
+        auto out = std::vector<float>(n);
+        rnd::sample::Dir::expectedMult(&dir[0], n, &out[0]);
+
+        REQUIRE(out == rnd::sample::Dir::expectedMult(&dir[0], n));
+
+        auto const dir_total = rnd::sample::Dir::dirichletTotal(&dir[0], n);
+        REQUIRE(dir_total == 15);
+
+        for (auto k = 0; k < n; ++k)
+        {
+            REQUIRE(rnd::sample::Dir::expectedProbability(&dir[0], n, dir_total, k) == out[k]);
+        }
+
+        rnd::sample::Dir::sampleMult(&dir[0], n, &out[0]);
+
+        auto total = 0.;
+        for (auto const p : out) { total += p; }
+
+        REQUIRE(total == Approx(1));
+
+        auto const certain = std::vector<float>({0, 0, 5.2f});
+
+        REQUIRE(rnd::sample::Dir::sampledProbability(&certain[0], 3, 5.2f, 0) == 0);
+        REQUIRE(rnd::sample::Dir::sampledProbability(&certain[0], 3, 5.2f, 2) == 1);
+        REQUIRE(rnd::sample::Dir::expectedProbability(&certain[0], 3, 5.2f, 2) == 1);
+
+        auto const empty = std::vector<float>(3);
+        REQUIRE(rnd::sample::Dir::expectedProbability(&empty[0], 3, 0, 1) == 0);
+    }
 }
 
 SCENARIO("calculating normal cdf", "[random][utils]")
@@ -183,3 +226,268 @@ SCENARIO("random ints", "[random][utils]")
     REQUIRE(rnd::slowRandomInt(0, 1) == 0);
     REQUIRE(rnd::slowRandomInt(107, 108) == 107);
 }
+
+SCENARIO("random streams per thread", "[random][utils]")
+{
+    // draws (uniform and normal) of the stream of the calling thread
+    auto const draws = [](std::uint64_t seed, unsigned int stream) {
+        rnd::seedStream(seed, stream);
+
+        std::vector<double> samples;
+        for (auto i = 0; i < 10; ++i)
+        {
+            samples.emplace_back(rnd::uniform_rand01());
+            samples.emplace_back(rnd::normal::sample(0, 1));
+            samples.emplace_back(rnd::draw(rnd::integerDistribution(0, 1000)));
+        }
+
+        return samples;
+    };
+
+    GIVEN("The same seed")
+    {
+        THEN("Streams are reproducible, also when drawn from other threads")
+        {
+            auto const stream_0 = draws(42, 0);
+            auto const stream_1 = draws(42, 1);
+
+            REQUIRE(stream_0 != stream_1);
+            REQUIRE(draws(42, 0) == stream_0);
+
+            auto thread_0 = std::async(std::launch::async, draws, 42, 0);
+            auto thread_1 = std::async(std::launch::async, draws, 42, 1);
+
+            REQUIRE(thread_0.get() == stream_0);
+            REQUIRE(thread_1.get() == stream_1);
+        }
+    }
+
+    GIVEN("Seeds that only differ in their upper 32 bits")
+    {
+        THEN("Their streams differ")
+        {
+            REQUIRE(draws(42, 0) != draws(42 + (std::uint64_t(1) << 32), 0));
+        }
+    }
+}
+
+SCENARIO("random engines", "[random][utils]")
+{
+    GIVEN("Known states")
+    {
+        THEN("xoshiro256** generates the reference output")
+        {
+            rnd::Xoshiro256 engine(1, 2, 3, 4);
+
+            REQUIRE(engine() == 11520u);
+            REQUIRE(engine() == 0u);
+            REQUIRE(engine() == 1509978240u);
+            REQUIRE(engine() == 1215971899390074240u);
+        }
+
+        THEN("philox4x32-10 generates the reference output")
+        {
+            std::uint32_t const zero_counter[4] = {0, 0, 0, 0};
+            std::uint32_t const zero_key[2]     = {0, 0};
+            std::uint32_t out[4];
+
+            rnd::Philox::block(zero_counter, zero_key, out);
+
+            REQUIRE(out[0] == 0x6627e8d5u);
+            REQUIRE(out[1] == 0xe169c58du);
+            REQUIRE(out[2] == 0xbc57ac4cu);
+            REQUIRE(out[3] == 0x9b00dbd8u);
+
+            std::uint32_t const max_counter[4] = {~0u, ~0u, ~0u, ~0u};
+            std::uint32_t const max_key[2]     = {~0u, ~0u};
+
+            rnd::Philox::block(max_counter, max_key, out);
+
+            REQUIRE(out[0] == 0x408f276du);
+            REQUIRE(out[1] == 0x41c83b0eu);
+            REQUIRE(out[2] == 0xa20bc7c6u);
+            REQUIRE(out[3] == 0x6d5451fdu);
+        }
+    }
+
+    GIVEN("A philox engine")
+    {
+        rnd::Philox engine(42, 3);
+
+        std::vector<rnd::Philox::result_type> stream;
+        for (auto i = 0; i < 10; ++i) { stream.emplace_back(engine()); }
+
+        THEN("Jumping back to a stream repeats it, other streams differ")
+        {
+            engine.jump(42, 3);
+            for (auto const x : stream) { REQUIRE(engine() == x); }
+
+            engine.jump(42, 4);
+            REQUIRE(engine() != stream[0]);
+        }
+    }
+
+    GIVEN("Simulation streams")
+    {
+        auto const draws = [](std::uint64_t simulation) {
+            rnd::seedSimulation(42, simulation);
+
+            std::vector<double> samples;
+            for (auto i = 0; i < 5; ++i)
+            {
+                samples.emplace_back(rnd::uniform_rand01());
+                samples.emplace_back(rnd::normal::sample(0, 1));
+            }
+
+            return samples;
+        };
+
+        THEN("They depend only on the seed and simulation, not on earlier draws or thread")
+        {
+            auto const simulation_7 = draws(7);
+
+            REQUIRE(draws(8) != simulation_7);
+            REQUIRE(draws(7) == simulation_7);
+            REQUIRE(std::async(std::launch::async, draws, 7).get() == simulation_7);
+        }
+    }
+}
+
+SCENARIO("sampling gammas in batches", "[random][utils]")
+{
+    GIVEN("Shapes below, at and above 1 (and 0), more than fit in a batch")
+    {
+        std::vector<float> const shapes = {0, .1f, .5f, 1, 2.5f, 10, 100};
+        auto const n                    = static_cast<int>(shapes.size());
+
+        THEN("The samples are distributed as those of sampling one at a time")
+        {
+            auto const num_samples = 20000;
+
+            std::vector<double> batch_sum(n), batch_squared_sum(n), sum(n), squared_sum(n),
+                samples(n);
+
+            for (auto i = 0; i < num_samples; ++i)
+            {
+                rnd::sample::gammas(shapes.data(), n, samples.data());
+
+                for (auto k = 0; k < n; ++k)
+                {
+                    REQUIRE(samples[k] >= 0);
+
+                    batch_sum[k] += samples[k];
+                    batch_squared_sum[k] += samples[k] * samples[k];
+
+                    auto const sample = rnd::sample::gamma(shapes[k]);
+
+                    sum[k] += sample;
+                    squared_sum[k] += sample * sample;
+                }
+            }
+
+            REQUIRE(batch_sum[0] == 0);
+
+            for (auto k = 1; k < n; ++k)
+            {
+                auto const batch_mean = batch_sum[k] / num_samples, mean = sum[k] / num_samples;
+                auto const batch_variance =
+                    batch_squared_sum[k] / num_samples - batch_mean * batch_mean;
+                auto const variance = squared_sum[k] / num_samples - mean * mean;
+
+                REQUIRE(
+                    std::abs(batch_mean - mean)
+                    < 5 * std::sqrt((batch_variance + variance) / num_samples));
+                REQUIRE(batch_variance == Approx(variance).epsilon(.25));
+            }
+        }
+    }
+}
+
+TEST_CASE("random engine benchmark", "[.benchmark][utils][random]")
+{
+    std::uniform_real_distribution<double> distr(0, 1);
+
+    std::mt19937 mt19937(42);
+    rnd::Xoshiro256 xoshiro256(42);
+    rnd::Philox philox(42);
+
+    // reports the time of 1000 draws (of 32 bit numbers and doubles) per engine
+    BENCHMARK("1000 draws, mt19937")
+    {
+        std::mt19937::result_type x = 0;
+        for (auto i = 0; i < 1000; ++i) { x ^= mt19937(); }
+        return x;
+    };
+
+    BENCHMARK("1000 draws, xoshiro256**")
+    {
+        rnd::Xoshiro256::result_type x = 0;
+        for (auto i = 0; i < 1000; ++i) { x ^= xoshiro256(); }
+        return x;
+    };
+
+    BENCHMARK("1000 draws, philox4x32-10")
+    {
+        rnd::Philox::result_type x = 0;
+        for (auto i = 0; i < 1000; ++i) { x ^= philox(); }
+        return x;
+    };
+
+    BENCHMARK("1000 uniform doubles, mt19937")
+    {
+        auto x = 0.;
+        for (auto i = 0; i < 1000; ++i) { x += distr(mt19937); }
+        return x;
+    };
+
+    BENCHMARK("1000 uniform doubles, xoshiro256**")
+    {
+        auto x = 0.;
+        for (auto i = 0; i < 1000; ++i) { x += distr(xoshiro256); }
+        return x;
+    };
+
+    BENCHMARK("1000 uniform doubles, philox4x32-10")
+    {
+        auto x = 0.;
+        for (auto i = 0; i < 1000; ++i) { x += distr(philox); }
+        return x;
+    };
+
+    BENCHMARK("1000 simulation streams, philox4x32-10")
+    {
+        rnd::Philox::result_type x = 0;
+        for (auto i = 0; i < 1000; ++i)
+        {
+            philox.jump(42, i);
+            x ^= philox();
+        }
+        return x;
+    };
+
+    BENCHMARK("1000 simulation streams, engine of rng()")
+    {
+        for (auto i = 0; i < 1000; ++i) { rnd::seedSimulation(42, i); }
+        return rnd::rng()();
+    };
+}
+
+TEST_CASE("gamma benchmark", "[.benchmark][utils][random]")
+{
+    std::vector<float> const dirichlet = {1, 3, .5f, 12, 2, 2, 7, 1, 1, 5, 4, .2f, 9, 1, 3, 6};
+    auto const n                       = static_cast<int>(dirichlet.size());
+
+    std::vector<double> samples(n);
+
+    BENCHMARK("16 gammas, one at a time")
+    {
+        for (auto k = 0; k < n; ++k) { samples[k] = rnd::sample::gamma(dirichlet[k]); }
+        return samples[0];
+    };
+
+    BENCHMARK("16 gammas, in batches")
+    {
+        rnd::sample::gammas(dirichlet.data(), n, samples.data());
+        return samples[0];
+    };
+}